@@ -13,6 +13,21 @@ static size_t default_growth_rate(Vec *v)
     return v->capacity * 2;
 }
 
+static void *vec_mem_realloc(const VecAllocator *allocator, void *ptr, size_t old_size, size_t new_size)
+{
+    if (allocator->realloc)
+        return allocator->realloc(allocator->context, ptr, old_size, new_size);
+    return realloc(ptr, new_size);
+}
+
+static void vec_mem_free(const VecAllocator *allocator, void *ptr, size_t size)
+{
+    if (allocator->free)
+        allocator->free(allocator->context, ptr, size);
+    else
+        free(ptr);
+}
+
 int vec_char_cmp(const void *data0, const void *data1)
 {
     /* compare the first byte */
@@ -78,6 +93,30 @@ int vec_ull_cmp(const void *data0, const void *data1)
     return -1;
 }
 
+int vec_float_cmp(const void *data0, const void *data1)
+{
+    if (!(data0 && data1))
+        return 0;
+    float d0 = *(float *)data0, d1 = *(float *)data1;
+    if (d0 == d1)
+        return 0;
+    if (d0 > d1)
+        return 1;
+    return -1;
+}
+
+int vec_double_cmp(const void *data0, const void *data1)
+{
+    if (!(data0 && data1))
+        return 0;
+    double d0 = *(double *)data0, d1 = *(double *)data1;
+    if (d0 == d1)
+        return 0;
+    if (d0 > d1)
+        return 1;
+    return -1;
+}
+
 Vec *vec_new(size_t capacity, size_t elem_size, void_cmp_func cmp, vec_growth_rate_func grow, void (*free_entry)(const void *))
 {
     VEC_ASSERT(elem_size != 0);
@@ -98,7 +137,7 @@ void vec_free(Vec *v)
 {
     VALIDATE_VECTOR(v);
     vec_clear(v);
-    free(v->data);
+    vec_mem_free(&v->allocator, v->data, v->capacity * v->elem_size * sizeof(byte));
     free(v);
 }
 
@@ -124,12 +163,12 @@ void vec_resize(Vec *v, size_t new_cap)
         return;
     if (!new_cap)
         new_cap++;
-    byte *new_data = (byte *)realloc(v->data, new_cap * v->elem_size * sizeof(byte));
+    byte *new_data = (byte *)vec_mem_realloc(&v->allocator, v->data, v->capacity * v->elem_size * sizeof(byte), new_cap * v->elem_size * sizeof(byte));
     VEC_ASSERT(new_data != NULL && "vec_resize: Failed to resize vec array.");
 
     /*  Initialize the newly allocated memory */
     size_t old_cap_start = v->capacity * v->elem_size * sizeof(byte);
-    if (old_cap_start < new_cap)
+    if (v->capacity < new_cap)
     {
         size_t region_len = new_cap - v->capacity;
         memset(new_data + old_cap_start, 0, region_len * v->elem_size * sizeof(byte));
@@ -138,6 +177,33 @@ void vec_resize(Vec *v, size_t new_cap)
     v->data = new_data;
 }
 
+void vec_set_allocator(Vec *v, const VecAllocator *allocator)
+{
+    VALIDATE_VECTOR(v);
+    VecAllocator new_allocator = {0};
+    if (allocator)
+        new_allocator = *allocator;
+    size_t size = v->capacity * v->elem_size * sizeof(byte);
+    byte *new_data = NULL;
+    if (size)
+    {
+        new_data = (byte *)vec_mem_realloc(&new_allocator, NULL, 0, size);
+        VEC_ASSERT(new_data != NULL && "vec_set_allocator: Failed to allocate vec array.");
+        memcpy(new_data, v->data, size);
+    }
+    vec_mem_free(&v->allocator, v->data, size);
+    v->data = new_data;
+    v->allocator = new_allocator;
+}
+
+void vec_detach(Vec *v)
+{
+    VALIDATE_VECTOR(v);
+    v->data = NULL;
+    v->len = 0;
+    v->capacity = 0;
+}
+
 void vec_push_back(Vec *v, void *data)
 {
     VALIDATE_VECTOR(v);
@@ -149,6 +215,26 @@ void vec_push_back(Vec *v, void *data)
     v->len++;
 }
 
+/* Key type of the numeric compare functions, 0 if v->cmp is not one of them or the entries are not that type */
+static int vec_cmp_key_type(const Vec *v, VecKeyType *key_type)
+{
+    if (v->cmp == vec_int_cmp && v->elem_size == sizeof(int32_t))
+        *key_type = VEC_KEY_INT32;
+    else if (v->cmp == vec_uint_cmp && v->elem_size == sizeof(uint32_t))
+        *key_type = VEC_KEY_UINT32;
+    else if (v->cmp == vec_float_cmp && v->elem_size == sizeof(float))
+        *key_type = VEC_KEY_FLOAT;
+    else if (v->cmp == vec_ll_cmp && v->elem_size == sizeof(int64_t))
+        *key_type = VEC_KEY_INT64;
+    else if (v->cmp == vec_ull_cmp && v->elem_size == sizeof(uint64_t))
+        *key_type = VEC_KEY_UINT64;
+    else if (v->cmp == vec_double_cmp && v->elem_size == sizeof(double))
+        *key_type = VEC_KEY_DOUBLE;
+    else
+        return 0;
+    return 1;
+}
+
 void vec_sort(Vec *v)
 {
     VALIDATE_VECTOR(v);
@@ -157,9 +243,154 @@ void vec_sort(Vec *v)
         perror("vec_sort: Compare function is undefined.");
         return;
     }
+    VecKeyType key_type;
+    if (vec_cmp_key_type(v, &key_type))
+    {
+        vec_sort_by_key(v, 0, key_type);
+        return;
+    }
     qsort(v->data, v->len, v->elem_size, v->cmp);
 }
 
+static size_t vec_key_size(VecKeyType key_type)
+{
+    return key_type == VEC_KEY_INT32 || key_type == VEC_KEY_UINT32 || key_type == VEC_KEY_FLOAT ? 4 : 8;
+}
+
+/* Maps a key to an unsigned integer with the same order, so the radix sort only compares bytes */
+static uint64_t vec_radix_key(const byte *key, VecKeyType key_type)
+{
+    uint32_t k32;
+    uint64_t k64;
+    switch (key_type)
+    {
+    case VEC_KEY_INT32:
+        memcpy(&k32, key, sizeof(k32));
+        return k32 ^ 0x80000000u;
+    case VEC_KEY_UINT32:
+        memcpy(&k32, key, sizeof(k32));
+        return k32;
+    case VEC_KEY_FLOAT:
+        /* Negative floats have all bits flipped so larger magnitudes sort first, positive ones only the sign */
+        memcpy(&k32, key, sizeof(k32));
+        return (k32 & 0x80000000u) ? (uint32_t)~k32 : k32 | 0x80000000u;
+    case VEC_KEY_INT64:
+        memcpy(&k64, key, sizeof(k64));
+        return k64 ^ 0x8000000000000000ull;
+    case VEC_KEY_UINT64:
+        memcpy(&k64, key, sizeof(k64));
+        return k64;
+    case VEC_KEY_DOUBLE:
+    default:
+        memcpy(&k64, key, sizeof(k64));
+        return (k64 & 0x8000000000000000ull) ? ~k64 : k64 | 0x8000000000000000ull;
+    }
+}
+
+void vec_argsort_by_key(const Vec *v, size_t key_offset, VecKeyType key_type, size_t *permutation)
+{
+    VALIDATE_VECTOR(v);
+    size_t n = v->len;
+    size_t key_size = vec_key_size(key_type);
+    VEC_ASSERT(key_offset + key_size <= v->elem_size);
+    if (n == 0)
+        return;
+    /* Keys and indices of both radix passes in one block */
+    size_t scratch_size = n * (2 * sizeof(uint64_t) + sizeof(size_t));
+    uint64_t *keys = (uint64_t *)vec_mem_realloc(&v->allocator, NULL, 0, scratch_size);
+    VEC_ASSERT(keys);
+    uint64_t *keys_tmp = keys + n;
+    size_t *order_tmp = (size_t *)(keys_tmp + n);
+    size_t i;
+    for (i = 0; i < n; i++)
+    {
+        keys[i] = vec_radix_key(v->data + i * v->elem_size + key_offset, key_type);
+        permutation[i] = i;
+    }
+    if (n < VEC_RADIX_SORT_MIN)
+    {
+        /* Stable insertion sort */
+        for (i = 1; i < n; i++)
+        {
+            uint64_t key = keys[i];
+            size_t j = i;
+            for (; j > 0 && keys[j - 1] > key; j--)
+            {
+                keys[j] = keys[j - 1];
+                permutation[j] = permutation[j - 1];
+            }
+            keys[j] = key;
+            permutation[j] = i;
+        }
+        vec_mem_free(&v->allocator, keys, scratch_size);
+        return;
+    }
+    /* The histograms of every byte are counted in one read of the keys */
+    size_t counts[8][256];
+    size_t b;
+    memset(counts, 0, key_size * sizeof(counts[0]));
+    for (i = 0; i < n; i++)
+    {
+        uint64_t key = keys[i];
+        for (b = 0; b < key_size; b++)
+            counts[b][(key >> (b * 8)) & 0xff]++;
+    }
+    uint64_t *src_keys = keys, *dst_keys = keys_tmp;
+    size_t *src_order = permutation, *dst_order = order_tmp;
+    for (b = 0; b < key_size; b++)
+    {
+        size_t shift = b * 8;
+        size_t *count = counts[b];
+        /* Every key has the same byte, the pass would not move anything */
+        if (count[(src_keys[0] >> shift) & 0xff] == n)
+            continue;
+        size_t offset = 0, digit;
+        for (digit = 0; digit < 256; digit++)
+        {
+            size_t c = count[digit];
+            count[digit] = offset;
+            offset += c;
+        }
+        for (i = 0; i < n; i++)
+        {
+            uint64_t key = src_keys[i];
+            size_t dst = count[(key >> shift) & 0xff]++;
+            dst_keys[dst] = key;
+            dst_order[dst] = src_order[i];
+        }
+        uint64_t *swap_keys = src_keys;
+        src_keys = dst_keys;
+        dst_keys = swap_keys;
+        size_t *swap_order = src_order;
+        src_order = dst_order;
+        dst_order = swap_order;
+    }
+    if (src_order != permutation)
+        memcpy(permutation, src_order, n * sizeof(size_t));
+    vec_mem_free(&v->allocator, keys, scratch_size);
+}
+
+void vec_sort_by_key(Vec *v, size_t key_offset, VecKeyType key_type)
+{
+    VALIDATE_VECTOR(v);
+    size_t n = v->len;
+    if (n < 2)
+        return;
+    /* Freed in reverse order, an arena allocator can then take both back */
+    size_t *permutation = (size_t *)vec_mem_realloc(&v->allocator, NULL, 0, n * sizeof(size_t));
+    byte *sorted = (byte *)vec_mem_realloc(&v->allocator, NULL, 0, n * v->elem_size * sizeof(byte));
+    VEC_ASSERT(permutation && sorted);
+    vec_argsort_by_key(v, key_offset, key_type, permutation);
+    size_t i;
+    for (i = 0; i < n; i++)
+    {
+        memcpy(sorted + i * v->elem_size, v->data + permutation[i] * v->elem_size, v->elem_size);
+    }
+    memcpy(v->data, sorted, n * v->elem_size * sizeof(byte));
+    vec_mem_free(&v->allocator, sorted, n * v->elem_size * sizeof(byte));
+    vec_mem_free(&v->allocator, permutation, n * sizeof(size_t));
+}
+
 void vec_insert(Vec *v, size_t index, void *data)
 {
     VALIDATE_VECTOR(v);
@@ -201,10 +432,11 @@ void vec_clamp(Vec *v)
 {
     VALIDATE_VECTOR(v);
     byte *tmp;
+    size_t old_size = v->capacity * v->elem_size * sizeof(byte);
     if (!v->len)
-        tmp = (byte *)realloc(v->data, v->elem_size * sizeof(byte));
+        tmp = (byte *)vec_mem_realloc(&v->allocator, v->data, old_size, v->elem_size * sizeof(byte));
     else
-        tmp = (byte *)realloc(v->data, v->len * v->elem_size * sizeof(byte));
+        tmp = (byte *)vec_mem_realloc(&v->allocator, v->data, old_size, v->len * v->elem_size * sizeof(byte));
     VEC_ASSERT(tmp);
     v->data = tmp;
     v->capacity = v->len;
@@ -294,17 +526,17 @@ Vec *vec_copy(Vec *v)
     VEC_ASSERT(ret);
     ret->grow = v->grow;
     ret->cmp = v->cmp;
+    ret->free_entry = NULL; /* entries are copied bytewise, freeing them in both vectors would free them twice */
+    ret->fe_idx = 0;
+    ret->allocator = (VecAllocator){0}; /* the copy can outlive the memory of an arena allocator */
     ret->elem_size = v->elem_size;
     ret->len = 0;
     ret->data = NULL;
     ret->capacity = 0;
     vec_resize(ret, v->capacity);
-    if (v->capacity == 0)
-    {
-        return ret;
-    }
-    VEC_ASSERT(ret->data && ret->capacity == v->capacity);
-    memcpy(ret->data, v->data, v->capacity);
+    VEC_ASSERT(ret->data && ret->capacity >= v->len);
+    memcpy(ret->data, v->data, v->len * v->elem_size * sizeof(byte));
+    ret->len = v->len;
     return ret;
 }
 
@@ -356,17 +588,60 @@ size_t vec_size(Vec *v)
 
 int vec_append(Vec *dest, Vec *source)
 {
+    VALIDATE_VECTOR(dest);
+    VALIDATE_VECTOR(source);
     if (dest->elem_size != source->elem_size)
         return 1;
+    size_t count = source->len; /* read before growing, source can be dest */
+    if (!count)
+        return 0;
+    vec_reserve(dest, dest->len + count);
+    memcpy(vec_at(dest, dest->len), source->data, count * dest->elem_size * sizeof(byte));
+    dest->len += count;
+    return 0;
+}
+
+void vec_reserve(Vec *v, size_t capacity)
+{
+    VALIDATE_VECTOR(v);
+    if (capacity <= v->capacity)
+        return;
+    /* Never grows by less than the growth function would, so repeated reserves stay amortized */
+    size_t grown = v->grow(v);
+    vec_resize(v, grown > capacity ? grown : capacity);
+}
+
+void vec_push_back_n(Vec *v, const void *data, size_t count)
+{
+    VALIDATE_VECTOR(v);
+    if (!data || !count)
+        return;
+    vec_reserve(v, v->len + count);
+    memcpy(vec_at(v, v->len), data, count * v->elem_size * sizeof(byte));
+    v->len += count;
+}
+
+size_t vec_remove_if(Vec *v, vec_predicate_func predicate, void *context)
+{
+    VALIDATE_VECTOR(v);
+    size_t kept = 0;
     size_t i;
-    for (i = 0; i < source->capacity; i++)
+    for (i = 0; i < v->len; i++)
     {
-        void *data = vec_at_s(source, i);
-        if (!data)
-            return 2;
-        vec_push_back(dest, data);
+        void *entry = vec_at(v, i);
+        if (predicate(entry, context))
+        {
+            if (v->free_entry)
+                v->free_entry(entry);
+            continue;
+        }
+        if (kept != i)
+            memcpy(vec_at(v, kept), entry, v->elem_size * sizeof(byte));
+        kept++;
     }
-    return 0;
+    size_t removed = v->len - kept;
+    v->len = kept;
+    return removed;
 }
 
 void *vec_arr_copy(Vec *v, size_t *ret_elem_count)
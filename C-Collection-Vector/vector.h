@@ -80,14 +80,47 @@ extern "C"
 
     int vec_ull_cmp(const void *data0, const void *data1);
 
+    int vec_float_cmp(const void *data0, const void *data1);
+
+    int vec_double_cmp(const void *data0, const void *data1);
+
+    /* Type of a sort key stored inside every entry, see vec_sort_by_key */
+    typedef enum
+    {
+        VEC_KEY_INT32,
+        VEC_KEY_UINT32,
+        VEC_KEY_FLOAT,
+        VEC_KEY_INT64,
+        VEC_KEY_UINT64,
+        VEC_KEY_DOUBLE,
+    } VecKeyType;
+
+/* Below this many entries the keys are insertion sorted instead of radix sorted */
+#define VEC_RADIX_SORT_MIN 64
+
     /**
      * @brief returns the new capcaity based on the current vec state
      *
      */
     typedef size_t (*vec_growth_rate_func)(Vec *);
 
+    /* Non zero if the entry should be removed, context is passed through from vec_remove_if */
+    typedef int (*vec_predicate_func)(const void *entry, void *context);
+
     void vec_deref_free(const void *data);
 
+    /*
+        Memory of the entries of a vector. A zeroed VecAllocator uses libc realloc and free.
+        realloc gets the old size so allocators that do not track sizes (arenas) can copy the entries,
+        ptr is NULL for a new allocation.
+    */
+    typedef struct
+    {
+        void *(*realloc)(void *context, void *ptr, size_t old_size, size_t new_size);
+        void (*free)(void *context, void *ptr, size_t size);
+        void *context;
+    } VecAllocator;
+
     struct Vec
     {
         byte *data;
@@ -98,6 +131,7 @@ extern "C"
         vec_growth_rate_func grow;
         void (*free_entry)(const void *);
         size_t fe_idx; /* use by VEC_FOR_EACH to ensure index after altering the vector */
+        VecAllocator allocator; /* of data, the Vec itself is always allocated with malloc */
     };
 
 /**
@@ -198,13 +232,60 @@ extern "C"
      */
     void vec_resize(Vec *v, size_t new_size);
 
+    /**
+     * @brief Moves the entries of the vector into memory from another allocator.
+     *
+     * @param v Vector to move.
+     * @param allocator Allocator of the new memory, NULL for libc.
+     *
+     * @details The old memory is freed with the old allocator. Sort scratch memory also comes from the allocator.
+     */
+    void vec_set_allocator(Vec *v, const VecAllocator *allocator);
+
+    /**
+     * @brief Drops the memory of the vector without freeing it, len and capacity become 0.
+     *
+     * @param v Vector to detach.
+     *
+     * @details For vectors whose allocator released all of its memory at once, like an arena reset.
+     * Entries are not freed with free_entry.
+     */
+    void vec_detach(Vec *v);
+
     /**
      * @brief Sorts the vector using libc qsort.
      *
      * @param v Vector to sort.
+     *
+     * @details A vector whose cmp is one of the numeric compare functions above (except vec_char_cmp)
+     * and whose entries have the size of that type is sorted with vec_sort_by_key instead.
      */
     void vec_sort(Vec *v);
 
+    /**
+     * @brief Stable sort by a numeric key stored in every entry, without calling a compare function.
+     *
+     * @param v Vector to sort.
+     * @param key_offset Offset of the key from the start of an entry, offsetof(Type, member).
+     * @param key_type Type of the key.
+     *
+     * @details The keys are copied out and LSD radix sorted 8 bits at a time, a pass is skipped when every
+     * key has the same byte, then the entries are moved to their place with one copy each.
+     * Floats are ordered by value with -0 before +0, NaNs with the sign bit clear sort after +infinity.
+     * Sorting by several keys is done by sorting by the least significant one first.
+     */
+    void vec_sort_by_key(Vec *v, size_t key_offset, VecKeyType key_type);
+
+    /**
+     * @brief Computes the order vec_sort_by_key would put the entries in, the vector is not changed.
+     *
+     * @param v Vector to read the keys from.
+     * @param key_offset Offset of the key from the start of an entry, offsetof(Type, member).
+     * @param key_type Type of the key.
+     * @param permutation Array of vec_size(v) entries, set so permutation[i] is the index of the i-th smallest entry.
+     */
+    void vec_argsort_by_key(const Vec *v, size_t key_offset, VecKeyType key_type, size_t *permutation);
+
     /**
      * @brief Inserts data into the vector at the specified index.
      *
@@ -337,11 +418,46 @@ extern "C"
      * @brief Adds all of the source vector to the destination vector.
      *
      * @param dest Destination vector.
-     * @param source Source vector.
-     * @return int 0 on success, 1 on fail, and 2 on partial fail.
+     * @param source Source vector, can be dest.
+     * @return int 0 on success, 1 if the element sizes differ.
+     *
+     * @details Grows dest at most once and copies every entry with one memcpy.
      */
     int vec_append(Vec *dest, Vec *source);
 
+    /**
+     * @brief Grows the vector so it holds at least capacity entries without reallocating.
+     *
+     * @param v Vector to grow.
+     * @param capacity Entries to make room for, a smaller value than the current capacity does nothing.
+     */
+    void vec_reserve(Vec *v, size_t capacity);
+
+    /**
+     * @brief Copies count entries from an array into the back of the vector.
+     *
+     * @param v Vector to push data into.
+     * @param data Array of count entries of elem_size bytes, must not point into v.
+     * @param count Number of entries.
+     *
+     * @details Grows the vector at most once.
+     */
+    void vec_push_back_n(Vec *v, const void *data, size_t count);
+
+    /**
+     * @brief Removes every entry the predicate returns non zero for, in one pass.
+     *
+     * @param v Vector to remove from.
+     * @param predicate Called once per entry in order.
+     * @param context Passed to predicate.
+     * @return size_t Number of removed entries.
+     *
+     * @details Keeps the order of the remaining entries. Calls the free function of every removed entry.
+     *
+     * @warning Must not be called from inside V_FOR_EACH.
+     */
+    size_t vec_remove_if(Vec *v, vec_predicate_func predicate, void *context);
+
     /**
      * @brief Returns a heap allocated deep copy of the vector.
      *
@@ -0,0 +1,110 @@
+/**
+ * @file vector_typed.h
+ * @brief Typed, inlined access to a Vec whose entries are all of one type.
+ *
+ * @warning Include after vector.h, the generated functions work on a plain Vec.
+ *
+ */
+
+#ifndef VECTOR_TYPED_H_
+#define VECTOR_TYPED_H_
+
+#include <string.h>
+#include "vector.h"
+
+/*
+    INFO:
+        VEC_DEFINE(type, prefix) generates static inline functions named prefix_vec_* that treat the
+        data of a Vec as an array of type. The size of an entry is known at compile time, so indexing
+        is plain pointer arithmetic, pushing and swapping are struct assignments and nothing goes
+        through a function call or a byte loop. The Vec itself is unchanged, a typed Vec can still be
+        passed to every vec_* function (vec_sort, vec_free, ...) and the other way around.
+        Only the slow path of prefix_vec_push_back calls out, to grow the Vec through its grow function.
+        The caller is responsible for only using the functions of one type on a Vec, prefix_vec_new
+        creates a Vec with the matching elem_size.
+
+        Example:
+            VEC_DEFINE(Projectile, projectile)
+            Vec *projectiles = projectile_vec_new(VECTOR_DEFAULT_CAP);
+            projectile_vec_push_back(projectiles, &projectile);
+            Projectile *first = projectile_vec_at(projectiles, 0);
+*/
+
+#define VEC_DEFINE(type, prefix)                                                              \
+    static inline Vec *prefix##_vec_new(size_t capacity)                                      \
+    {                                                                                         \
+        return vec_new(capacity, sizeof(type), NULL, NULL, NULL);                             \
+    }                                                                                         \
+                                                                                              \
+    static inline size_t prefix##_vec_size(const Vec *v)                                      \
+    {                                                                                         \
+        return v->len;                                                                        \
+    }                                                                                         \
+                                                                                              \
+    static inline type *prefix##_vec_data(Vec *v)                                             \
+    {                                                                                         \
+        return (type *)v->data;                                                               \
+    }                                                                                         \
+                                                                                              \
+    /* No bounds check, same as vec_at */                                                     \
+    static inline type *prefix##_vec_at(Vec *v, size_t index)                                 \
+    {                                                                                         \
+        return (type *)v->data + index;                                                       \
+    }                                                                                         \
+                                                                                              \
+    /* Appends an uninitialized entry and returns it */                                       \
+    static inline type *prefix##_vec_emplace_back(Vec *v)                                     \
+    {                                                                                         \
+        if (v->len >= v->capacity)                                                            \
+            vec_resize(v, v->grow(v));                                                        \
+        return (type *)v->data + v->len++;                                                    \
+    }                                                                                         \
+                                                                                              \
+    static inline void prefix##_vec_push_back(Vec *v, const type *value)                      \
+    {                                                                                         \
+        *prefix##_vec_emplace_back(v) = *value;                                               \
+    }                                                                                         \
+                                                                                              \
+    static inline void prefix##_vec_swap(Vec *v, size_t idx0, size_t idx1)                    \
+    {                                                                                         \
+        type *data = (type *)v->data;                                                         \
+        type tmp = data[idx0];                                                                \
+        data[idx0] = data[idx1];                                                              \
+        data[idx1] = tmp;                                                                     \
+    }                                                                                         \
+                                                                                              \
+    /* Moves the last entry into index, keeps the fe_idx adjustment of vec_remove_fast */     \
+    static inline void prefix##_vec_remove_fast(Vec *v, size_t index)                         \
+    {                                                                                         \
+        if (index >= v->len)                                                                  \
+            return;                                                                           \
+        if (v->fe_idx != INVALID_FE_IDX)                                                      \
+            v->fe_idx--;                                                                      \
+        type *data = (type *)v->data;                                                         \
+        data[index] = data[--v->len];                                                         \
+    }                                                                                         \
+                                                                                              \
+    /* Keeps the order of the entries, keeps the fe_idx adjustment of vec_remove */           \
+    static inline void prefix##_vec_remove(Vec *v, size_t index)                              \
+    {                                                                                         \
+        if (index >= v->len)                                                                  \
+            return;                                                                           \
+        if (v->fe_idx != INVALID_FE_IDX)                                                      \
+            v->fe_idx--;                                                                      \
+        type *data = (type *)v->data;                                                         \
+        memmove(data + index, data + index + 1, (v->len - index - 1) * sizeof(type));         \
+        v->len--;                                                                             \
+    }                                                                                         \
+                                                                                              \
+    /* Unlike vec_clear the unused capacity is not zeroed, free_entry is still called */      \
+    static inline void prefix##_vec_clear(Vec *v)                                             \
+    {                                                                                         \
+        if (v->free_entry)                                                                    \
+        {                                                                                     \
+            vec_clear(v);                                                                     \
+            return;                                                                           \
+        }                                                                                     \
+        v->len = 0;                                                                           \
+    }
+
+#endif /* VECTOR_TYPED_H_ */
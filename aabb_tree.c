@@ -0,0 +1,531 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "aabb_tree.h"
+
+static void *aabb_tree_realloc(void *ptr, size_t size)
+{
+    void *tmp = realloc(ptr, size);
+    if (!tmp)
+    {
+        fprintf(stderr, "Failed to allocate memory for aabb tree\n");
+        exit(1);
+    }
+    return tmp;
+}
+
+static bool node_is_leaf(AABBTreeNode *node)
+{
+    return node->child1 == AABB_TREE_NULL;
+}
+
+static float perimeter(Vector2 min, Vector2 max)
+{
+    return 2.0f * ((max.x - min.x) + (max.y - min.y));
+}
+
+static bool overlaps(Vector2 min_a, Vector2 max_a, Vector2 min_b, Vector2 max_b)
+{
+    return !(max_a.x < min_b.x || max_b.x < min_a.x || max_a.y < min_b.y || max_b.y < min_a.y);
+}
+
+static void combine(AABBTreeNode *dest, AABBTreeNode *a, AABBTreeNode *b)
+{
+    dest->min = (Vector2){fminf(a->min.x, b->min.x), fminf(a->min.y, b->min.y)};
+    dest->max = (Vector2){fmaxf(a->max.x, b->max.x), fmaxf(a->max.y, b->max.y)};
+}
+
+static float combined_perimeter(AABBTreeNode *a, AABBTreeNode *b)
+{
+    return perimeter((Vector2){fminf(a->min.x, b->min.x), fminf(a->min.y, b->min.y)},
+                     (Vector2){fmaxf(a->max.x, b->max.x), fmaxf(a->max.y, b->max.y)});
+}
+
+static int max_int(int a, int b)
+{
+    return a > b ? a : b;
+}
+
+static int allocate_node(AABBTree *tree)
+{
+    if (tree->free_list == AABB_TREE_NULL)
+    {
+        int old_capacity = tree->node_capacity, i;
+        tree->node_capacity = old_capacity ? old_capacity * 2 : 16;
+        tree->nodes = (AABBTreeNode *)aabb_tree_realloc(tree->nodes, tree->node_capacity * sizeof(AABBTreeNode));
+        for (i = old_capacity; i < tree->node_capacity; i++)
+        {
+            tree->nodes[i].parent = i + 1 < tree->node_capacity ? i + 1 : AABB_TREE_NULL;
+            tree->nodes[i].height = -1;
+        }
+        tree->free_list = old_capacity;
+    }
+    int node = tree->free_list;
+    tree->free_list = tree->nodes[node].parent;
+    tree->nodes[node].parent = AABB_TREE_NULL;
+    tree->nodes[node].child1 = AABB_TREE_NULL;
+    tree->nodes[node].child2 = AABB_TREE_NULL;
+    tree->nodes[node].height = 0;
+    tree->nodes[node].user = -1;
+    tree->node_count++;
+    return node;
+}
+
+static void free_node(AABBTree *tree, int node)
+{
+    tree->nodes[node].parent = tree->free_list;
+    tree->nodes[node].height = -1;
+    tree->free_list = node;
+    tree->node_count--;
+}
+
+static void push_stack(AABBTree *tree, int *count, int value)
+{
+    if (*count >= tree->stack_capacity)
+    {
+        tree->stack_capacity = tree->stack_capacity ? tree->stack_capacity * 2 : 64;
+        tree->stack = (int *)aabb_tree_realloc(tree->stack, tree->stack_capacity * sizeof(int));
+    }
+    tree->stack[(*count)++] = value;
+}
+
+/* Rotates the taller grandchild up if the node is imbalanced, returns the new subtree root */
+static int balance(AABBTree *tree, int ia)
+{
+    AABBTreeNode *a = &tree->nodes[ia];
+    if (node_is_leaf(a) || a->height < 2)
+    {
+        return ia;
+    }
+    int ib = a->child1, ic = a->child2;
+    AABBTreeNode *b = &tree->nodes[ib], *c = &tree->nodes[ic];
+    int diff = c->height - b->height;
+    if (diff > 1)
+    {
+        /* Rotate c up */
+        int i_f = c->child1, ig = c->child2;
+        AABBTreeNode *f = &tree->nodes[i_f], *g = &tree->nodes[ig];
+        c->child1 = ia;
+        c->parent = a->parent;
+        a->parent = ic;
+        if (c->parent != AABB_TREE_NULL)
+        {
+            if (tree->nodes[c->parent].child1 == ia)
+                tree->nodes[c->parent].child1 = ic;
+            else
+                tree->nodes[c->parent].child2 = ic;
+        }
+        else
+        {
+            tree->root = ic;
+        }
+        if (f->height > g->height)
+        {
+            c->child2 = i_f;
+            a->child2 = ig;
+            g->parent = ia;
+            combine(a, b, g);
+            combine(c, a, f);
+            a->height = 1 + max_int(b->height, g->height);
+            c->height = 1 + max_int(a->height, f->height);
+        }
+        else
+        {
+            c->child2 = ig;
+            a->child2 = i_f;
+            f->parent = ia;
+            combine(a, b, f);
+            combine(c, a, g);
+            a->height = 1 + max_int(b->height, f->height);
+            c->height = 1 + max_int(a->height, g->height);
+        }
+        return ic;
+    }
+    if (diff < -1)
+    {
+        /* Rotate b up */
+        int id = b->child1, ie = b->child2;
+        AABBTreeNode *d = &tree->nodes[id], *e = &tree->nodes[ie];
+        b->child1 = ia;
+        b->parent = a->parent;
+        a->parent = ib;
+        if (b->parent != AABB_TREE_NULL)
+        {
+            if (tree->nodes[b->parent].child1 == ia)
+                tree->nodes[b->parent].child1 = ib;
+            else
+                tree->nodes[b->parent].child2 = ib;
+        }
+        else
+        {
+            tree->root = ib;
+        }
+        if (d->height > e->height)
+        {
+            b->child2 = id;
+            a->child1 = ie;
+            e->parent = ia;
+            combine(a, c, e);
+            combine(b, a, d);
+            a->height = 1 + max_int(c->height, e->height);
+            b->height = 1 + max_int(a->height, d->height);
+        }
+        else
+        {
+            b->child2 = ie;
+            a->child1 = id;
+            d->parent = ia;
+            combine(a, c, d);
+            combine(b, a, e);
+            a->height = 1 + max_int(c->height, d->height);
+            b->height = 1 + max_int(a->height, e->height);
+        }
+        return ib;
+    }
+    return ia;
+}
+
+/* Walks from node to the root refitting AABBs and heights */
+static void refit_ancestors(AABBTree *tree, int node)
+{
+    while (node != AABB_TREE_NULL)
+    {
+        node = balance(tree, node);
+        AABBTreeNode *n = &tree->nodes[node];
+        AABBTreeNode *child1 = &tree->nodes[n->child1], *child2 = &tree->nodes[n->child2];
+        n->height = 1 + max_int(child1->height, child2->height);
+        combine(n, child1, child2);
+        node = n->parent;
+    }
+}
+
+static void insert_leaf(AABBTree *tree, int leaf)
+{
+    if (tree->root == AABB_TREE_NULL)
+    {
+        tree->root = leaf;
+        tree->nodes[leaf].parent = AABB_TREE_NULL;
+        return;
+    }
+
+    /* Find the best sibling by the perimeter heuristic */
+    AABBTreeNode *leaf_node = &tree->nodes[leaf];
+    int index = tree->root;
+    while (!node_is_leaf(&tree->nodes[index]))
+    {
+        AABBTreeNode *node = &tree->nodes[index];
+        AABBTreeNode *child1 = &tree->nodes[node->child1], *child2 = &tree->nodes[node->child2];
+        float area = perimeter(node->min, node->max);
+        float combined_area = combined_perimeter(node, leaf_node);
+        /* Cost of creating a new parent for this node and the new leaf */
+        float cost = 2.0f * combined_area;
+        /* Minimum cost of pushing the leaf further down the tree */
+        float inheritance = 2.0f * (combined_area - area);
+        float cost1 = combined_perimeter(child1, leaf_node) + inheritance;
+        float cost2 = combined_perimeter(child2, leaf_node) + inheritance;
+        if (!node_is_leaf(child1))
+            cost1 -= perimeter(child1->min, child1->max);
+        if (!node_is_leaf(child2))
+            cost2 -= perimeter(child2->min, child2->max);
+        if (cost < cost1 && cost < cost2)
+        {
+            break;
+        }
+        index = cost1 < cost2 ? node->child1 : node->child2;
+    }
+    int sibling = index;
+
+    /* allocate_node can move the node array, so only indices are held across it */
+    int new_parent = allocate_node(tree);
+    int old_parent = tree->nodes[sibling].parent;
+    AABBTreeNode *parent = &tree->nodes[new_parent];
+    parent->parent = old_parent;
+    combine(parent, &tree->nodes[leaf], &tree->nodes[sibling]);
+    parent->height = tree->nodes[sibling].height + 1;
+    parent->child1 = sibling;
+    parent->child2 = leaf;
+    tree->nodes[sibling].parent = new_parent;
+    tree->nodes[leaf].parent = new_parent;
+    if (old_parent != AABB_TREE_NULL)
+    {
+        if (tree->nodes[old_parent].child1 == sibling)
+            tree->nodes[old_parent].child1 = new_parent;
+        else
+            tree->nodes[old_parent].child2 = new_parent;
+    }
+    else
+    {
+        tree->root = new_parent;
+    }
+    refit_ancestors(tree, tree->nodes[leaf].parent);
+}
+
+static void remove_leaf(AABBTree *tree, int leaf)
+{
+    if (leaf == tree->root)
+    {
+        tree->root = AABB_TREE_NULL;
+        return;
+    }
+    int parent = tree->nodes[leaf].parent;
+    int grand_parent = tree->nodes[parent].parent;
+    int sibling = tree->nodes[parent].child1 == leaf ? tree->nodes[parent].child2 : tree->nodes[parent].child1;
+    if (grand_parent != AABB_TREE_NULL)
+    {
+        if (tree->nodes[grand_parent].child1 == parent)
+            tree->nodes[grand_parent].child1 = sibling;
+        else
+            tree->nodes[grand_parent].child2 = sibling;
+        tree->nodes[sibling].parent = grand_parent;
+        free_node(tree, parent);
+        refit_ancestors(tree, grand_parent);
+    }
+    else
+    {
+        tree->root = sibling;
+        tree->nodes[sibling].parent = AABB_TREE_NULL;
+        free_node(tree, parent);
+    }
+}
+
+static void fatten(AABBTreeNode *node, Vector2 min, Vector2 max, Vector2 displacement)
+{
+    node->min = (Vector2){min.x - AABB_TREE_FAT_MARGIN, min.y - AABB_TREE_FAT_MARGIN};
+    node->max = (Vector2){max.x + AABB_TREE_FAT_MARGIN, max.y + AABB_TREE_FAT_MARGIN};
+    Vector2 d = {displacement.x * AABB_TREE_DISPLACEMENT_MULTIPLIER, displacement.y * AABB_TREE_DISPLACEMENT_MULTIPLIER};
+    if (d.x < 0)
+        node->min.x += d.x;
+    else
+        node->max.x += d.x;
+    if (d.y < 0)
+        node->min.y += d.y;
+    else
+        node->max.y += d.y;
+}
+
+int aabb_tree_pair_cmp(const void *data0, const void *data1)
+{
+    const AABBTreePair *p0 = (const AABBTreePair *)data0, *p1 = (const AABBTreePair *)data1;
+    if (p0->a != p1->a)
+        return p0->a < p1->a ? -1 : 1;
+    if (p0->b != p1->b)
+        return p0->b < p1->b ? -1 : 1;
+    return 0;
+}
+
+AABBTree *aabb_tree_new(void)
+{
+    AABBTree *tree = (AABBTree *)calloc(1, sizeof(AABBTree));
+    if (!tree)
+    {
+        fprintf(stderr, "Failed to allocate memory for aabb tree\n");
+        exit(1);
+    }
+    tree->root = AABB_TREE_NULL;
+    tree->free_list = AABB_TREE_NULL;
+    return tree;
+}
+
+void aabb_tree_free(AABBTree *tree)
+{
+    if (!tree)
+        return;
+    free(tree->nodes);
+    free(tree->stack);
+    free(tree);
+}
+
+int aabb_tree_insert(AABBTree *tree, int user, Vector2 min, Vector2 max, Vector2 displacement)
+{
+    int proxy = allocate_node(tree);
+    fatten(&tree->nodes[proxy], min, max, displacement);
+    tree->nodes[proxy].user = user;
+    insert_leaf(tree, proxy);
+    tree->leaf_count++;
+    return proxy;
+}
+
+void aabb_tree_remove(AABBTree *tree, int proxy)
+{
+    remove_leaf(tree, proxy);
+    free_node(tree, proxy);
+    tree->leaf_count--;
+}
+
+bool aabb_tree_move(AABBTree *tree, int proxy, Vector2 min, Vector2 max, Vector2 displacement)
+{
+    AABBTreeNode *node = &tree->nodes[proxy];
+    /* The fat AABB has to cover the whole sweep of the next tick for swept narrow phase tests */
+    Vector2 swept_min = {fminf(min.x, min.x + displacement.x), fminf(min.y, min.y + displacement.y)};
+    Vector2 swept_max = {fmaxf(max.x, max.x + displacement.x), fmaxf(max.y, max.y + displacement.y)};
+    bool contained = node->min.x <= swept_min.x && node->min.y <= swept_min.y && swept_max.x <= node->max.x && swept_max.y <= node->max.y;
+    if (contained)
+    {
+        /* Reinsert anyway if the entity slowed down and the fat AABB is far too big for it */
+        float slack = 4.0f * AABB_TREE_FAT_MARGIN + 4.0f * AABB_TREE_DISPLACEMENT_MULTIPLIER * (fabsf(displacement.x) + fabsf(displacement.y));
+        if ((node->max.x - node->min.x) - (max.x - min.x) <= slack && (node->max.y - node->min.y) - (max.y - min.y) <= slack)
+        {
+            return false;
+        }
+    }
+    remove_leaf(tree, proxy);
+    fatten(&tree->nodes[proxy], min, max, displacement);
+    insert_leaf(tree, proxy);
+    return true;
+}
+
+void aabb_tree_set_user(AABBTree *tree, int proxy, int user)
+{
+    tree->nodes[proxy].user = user;
+}
+
+int aabb_tree_get_user(AABBTree *tree, int proxy)
+{
+    return tree->nodes[proxy].user;
+}
+
+void aabb_tree_query(AABBTree *tree, Vector2 min, Vector2 max, Vec *users)
+{
+    if (tree->root == AABB_TREE_NULL)
+        return;
+    int count = 0;
+    push_stack(tree, &count, tree->root);
+    while (count)
+    {
+        AABBTreeNode *node = &tree->nodes[tree->stack[--count]];
+        if (!overlaps(node->min, node->max, min, max))
+        {
+            continue;
+        }
+        if (node_is_leaf(node))
+        {
+            int_vec_push_back(users, &node->user);
+        }
+        else
+        {
+            int child1 = node->child1, child2 = node->child2;
+            push_stack(tree, &count, child1);
+            push_stack(tree, &count, child2);
+        }
+    }
+}
+
+/* Slab test, inv_delta holds 1 / (end - start), infinite on an axis the segment is parallel to */
+static bool segment_crosses(Vector2 min, Vector2 max, Vector2 start, Vector2 inv_delta)
+{
+    float tx0 = (min.x - start.x) * inv_delta.x, tx1 = (max.x - start.x) * inv_delta.x;
+    float ty0 = (min.y - start.y) * inv_delta.y, ty1 = (max.y - start.y) * inv_delta.y;
+    /* 0 * infinity is NaN for a parallel segment exactly on a slab plane, fminf and fmaxf ignore it */
+    float enter = fmaxf(fmaxf(fminf(tx0, tx1), fminf(ty0, ty1)), 0.0f);
+    float exit = fminf(fminf(fmaxf(tx0, tx1), fmaxf(ty0, ty1)), 1.0f);
+    return enter <= exit;
+}
+
+void aabb_tree_query_segment(AABBTree *tree, Vector2 start, Vector2 end, Vec *users)
+{
+    if (tree->root == AABB_TREE_NULL)
+        return;
+    Vector2 inv_delta = {1.0f / (end.x - start.x), 1.0f / (end.y - start.y)};
+    int count = 0;
+    push_stack(tree, &count, tree->root);
+    while (count)
+    {
+        AABBTreeNode *node = &tree->nodes[tree->stack[--count]];
+        if (!segment_crosses(node->min, node->max, start, inv_delta))
+        {
+            continue;
+        }
+        if (node_is_leaf(node))
+        {
+            int_vec_push_back(users, &node->user);
+        }
+        else
+        {
+            int child1 = node->child1, child2 = node->child2;
+            push_stack(tree, &count, child1);
+            push_stack(tree, &count, child2);
+        }
+    }
+}
+
+void aabb_tree_query_pairs(AABBTree *tree, Vec *pairs)
+{
+    int leaf;
+    for (leaf = 0; leaf < tree->node_capacity; leaf++)
+    {
+        AABBTreeNode *query = &tree->nodes[leaf];
+        if (query->height != 0)
+        {
+            continue;
+        }
+        int count = 0;
+        push_stack(tree, &count, tree->root);
+        while (count)
+        {
+            int index = tree->stack[--count];
+            AABBTreeNode *node = &tree->nodes[index];
+            if (!overlaps(node->min, node->max, query->min, query->max))
+            {
+                continue;
+            }
+            if (node_is_leaf(node))
+            {
+                /* Only the leaf with the lower proxy reports the pair */
+                if (index > leaf)
+                {
+                    AABBTreePair pair = query->user < node->user ? (AABBTreePair){query->user, node->user} : (AABBTreePair){node->user, query->user};
+                    aabb_tree_pair_vec_push_back(pairs, &pair);
+                }
+            }
+            else
+            {
+                int child1 = node->child1, child2 = node->child2;
+                push_stack(tree, &count, child1);
+                push_stack(tree, &count, child2);
+            }
+        }
+    }
+}
+
+void aabb_tree_query_tree(AABBTree *tree_a, AABBTree *tree_b, Vec *pairs)
+{
+    if (tree_a->root == AABB_TREE_NULL || tree_b->root == AABB_TREE_NULL)
+        return;
+    /* The stack of tree_a holds node pairs, a node of tree_a followed by a node of tree_b */
+    int count = 0;
+    push_stack(tree_a, &count, tree_a->root);
+    push_stack(tree_a, &count, tree_b->root);
+    while (count)
+    {
+        int index_b = tree_a->stack[--count];
+        int index_a = tree_a->stack[--count];
+        AABBTreeNode *a = &tree_a->nodes[index_a], *b = &tree_b->nodes[index_b];
+        if (!overlaps(a->min, a->max, b->min, b->max))
+        {
+            continue;
+        }
+        bool leaf_a = node_is_leaf(a), leaf_b = node_is_leaf(b);
+        if (leaf_a && leaf_b)
+        {
+            AABBTreePair pair = {a->user, b->user};
+            aabb_tree_pair_vec_push_back(pairs, &pair);
+        }
+        else if (leaf_b || (!leaf_a && perimeter(a->min, a->max) >= perimeter(b->min, b->max)))
+        {
+            /* Descend the larger node */
+            int child1 = a->child1, child2 = a->child2;
+            push_stack(tree_a, &count, child1);
+            push_stack(tree_a, &count, index_b);
+            push_stack(tree_a, &count, child2);
+            push_stack(tree_a, &count, index_b);
+        }
+        else
+        {
+            int child1 = b->child1, child2 = b->child2;
+            push_stack(tree_a, &count, index_a);
+            push_stack(tree_a, &count, child1);
+            push_stack(tree_a, &count, index_a);
+            push_stack(tree_a, &count, child2);
+        }
+    }
+}
@@ -0,0 +1,177 @@
+/**
+ * @file aabb_tree.h
+ * @brief Dynamic bounding volume tree of fat AABBs. Leaves are inserted once per entity
+ * and moved every tick, only leaves that escape their fat AABB are reinserted.
+ *
+ */
+
+#ifndef AABB_TREE_H_
+#define AABB_TREE_H_
+
+#include <stdbool.h>
+#include <raylib.h>
+#include "C-Collection-Vector/vector.h"
+#include "C-Collection-Vector/vector_typed.h"
+
+/*
+    INFO:
+        Proxies are node indices and stay valid until aabb_tree_remove.
+        Every leaf stores an int user id, the tree never interprets it.
+        If the caller stores entities in a Vec and removes them with vec_remove_fast,
+        aabb_tree_set_user has to be called for the entry that was moved.
+*/
+
+#define AABB_TREE_NULL (-1)
+/* Added to every side of a leaf's AABB so slow entities do not need a reinsert every tick */
+#define AABB_TREE_FAT_MARGIN 4.0f
+/* Fat AABBs are extended along the displacement by this many ticks of movement */
+#define AABB_TREE_DISPLACEMENT_MULTIPLIER 2.0f
+
+/* Pair of user ids emitted by the pair queries */
+typedef struct
+{
+    int a;
+    int b;
+} AABBTreePair;
+
+VEC_DEFINE(AABBTreePair, aabb_tree_pair)
+VEC_DEFINE(int, int)
+
+/* 0 if eq, -1 if less, 1 if greater than, orders by a then b. Can be used as the cmp of a Vec of AABBTreePair */
+int aabb_tree_pair_cmp(const void *data0, const void *data1);
+
+typedef struct
+{
+    Vector2 min;
+    Vector2 max;
+    int parent; /* next free node when the node is on the free list */
+    int child1;
+    int child2;
+    int height; /* 0 for leaves, -1 for free nodes */
+    int user;
+} AABBTreeNode;
+
+typedef struct
+{
+    AABBTreeNode *nodes;
+    int node_count;
+    int node_capacity;
+    int root;
+    int free_list;
+    int leaf_count;
+    int *stack; /* traversal stack shared by the queries */
+    int stack_capacity;
+} AABBTree;
+
+/**
+ * @brief Creates an empty tree.
+ *
+ * @return AABBTree*
+ */
+AABBTree *aabb_tree_new(void);
+
+/**
+ * @brief Frees the tree and all of its nodes.
+ *
+ * @param tree Tree to free.
+ */
+void aabb_tree_free(AABBTree *tree);
+
+/**
+ * @brief Inserts a leaf with a fattened copy of the given AABB.
+ *
+ * @param tree Tree to insert into.
+ * @param user User id stored in the leaf.
+ * @param min Top left corner of the tight AABB.
+ * @param max Bottom right corner of the tight AABB.
+ * @param displacement Expected movement over the next tick, used to extend the fat AABB like aabb_tree_move does.
+ * @return int Proxy used to move or remove the leaf.
+ */
+int aabb_tree_insert(AABBTree *tree, int user, Vector2 min, Vector2 max, Vector2 displacement);
+
+/**
+ * @brief Removes a leaf, the proxy is invalid afterwards.
+ *
+ * @param tree Tree to remove from.
+ * @param proxy Proxy returned by aabb_tree_insert.
+ */
+void aabb_tree_remove(AABBTree *tree, int proxy);
+
+/**
+ * @brief Updates a leaf with the entity's new tight AABB.
+ *
+ * @param tree Tree containing the leaf.
+ * @param proxy Proxy returned by aabb_tree_insert.
+ * @param min Top left corner of the tight AABB.
+ * @param max Bottom right corner of the tight AABB.
+ * @param displacement Expected movement over the next tick, used to extend the fat AABB.
+ * @return true if the leaf was reinserted.
+ *
+ * @details Does nothing while the tight AABB and the tight AABB moved by displacement stay inside the
+ * fat AABB and the fat AABB has not grown too large for them, so most calls only cost a few compares.
+ * Pair queries therefore find every pair that can touch during the next tick.
+ */
+bool aabb_tree_move(AABBTree *tree, int proxy, Vector2 min, Vector2 max, Vector2 displacement);
+
+/**
+ * @brief Changes the user id of a leaf.
+ *
+ * @param tree Tree containing the leaf.
+ * @param proxy Proxy returned by aabb_tree_insert.
+ * @param user New user id.
+ */
+void aabb_tree_set_user(AABBTree *tree, int proxy, int user);
+
+/**
+ * @brief Returns the user id of a leaf.
+ *
+ * @param tree Tree containing the leaf.
+ * @param proxy Proxy returned by aabb_tree_insert.
+ * @return int User id.
+ */
+int aabb_tree_get_user(AABBTree *tree, int proxy);
+
+/**
+ * @brief Pushes the user id of every leaf whose fat AABB overlaps the given AABB.
+ *
+ * @param tree Tree to query.
+ * @param min Top left corner of the query AABB.
+ * @param max Bottom right corner of the query AABB.
+ * @param users Vec of int, ids are appended and it is not cleared.
+ */
+void aabb_tree_query(AABBTree *tree, Vector2 min, Vector2 max, Vec *users);
+
+/**
+ * @brief Pushes the user id of every leaf whose fat AABB the segment from start to end crosses.
+ *
+ * @param tree Tree to query.
+ * @param start First point of the segment.
+ * @param end Last point of the segment.
+ * @param users Vec of int, ids are appended and it is not cleared.
+ *
+ * @details Nodes are tested with the slab test, subtrees the segment misses are skipped whole.
+ */
+void aabb_tree_query_segment(AABBTree *tree, Vector2 start, Vector2 end, Vec *users);
+
+/**
+ * @brief Pushes every unique pair of leaves in the tree with overlapping fat AABBs.
+ *
+ * @param tree Tree to query.
+ * @param pairs Vec of AABBTreePair, pairs are appended and it is not cleared.
+ *
+ * @details Pairs are emitted once, with the lower user id in a.
+ */
+void aabb_tree_query_pairs(AABBTree *tree, Vec *pairs);
+
+/**
+ * @brief Pushes every pair of leaves, one from each tree, with overlapping fat AABBs.
+ *
+ * @param tree_a First tree, its user ids are stored in AABBTreePair.a.
+ * @param tree_b Second tree, its user ids are stored in AABBTreePair.b.
+ * @param pairs Vec of AABBTreePair, pairs are appended and it is not cleared.
+ *
+ * @details Both trees are descended together so subtrees that do not overlap are skipped whole.
+ */
+void aabb_tree_query_tree(AABBTree *tree_a, AABBTree *tree_b, Vec *pairs);
+
+#endif
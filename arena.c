@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+struct ArenaBlock
+{
+    ArenaBlock *next;
+    size_t size;
+};
+
+/* Keeps the memory after the header of an overflow block aligned */
+#define ARENA_BLOCK_HEADER ((sizeof(ArenaBlock) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+static void *arena_malloc(size_t size)
+{
+    void *ptr = malloc(size);
+    if (!ptr)
+    {
+        fprintf(stderr, "Failed to allocate memory for arena\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+static size_t arena_align(size_t size)
+{
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+/* ptr of size bytes ends where the next allocation would start */
+static int arena_is_top(const Arena *arena, const void *ptr, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)ptr;
+    return bytes >= arena->base && bytes <= arena->base + arena->used && bytes + arena_align(size) == arena->base + arena->used;
+}
+
+Arena *arena_new(size_t capacity)
+{
+    Arena *arena = (Arena *)arena_malloc(sizeof(Arena));
+    memset(arena, 0, sizeof(Arena));
+    arena->capacity = arena_align(capacity > 0 ? capacity : ARENA_ALIGNMENT);
+    arena->base = (unsigned char *)arena_malloc(arena->capacity);
+    return arena;
+}
+
+static void arena_free_overflow(Arena *arena)
+{
+    ArenaBlock *block = arena->overflow;
+    while (block)
+    {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->overflow = NULL;
+}
+
+void arena_free(Arena *arena)
+{
+    if (!arena)
+        return;
+    arena_free_overflow(arena);
+    free(arena->base);
+    free(arena);
+}
+
+void *arena_alloc(Arena *arena, size_t size)
+{
+    size = arena_align(size);
+    if (size <= arena->capacity - arena->used)
+    {
+        void *ptr = arena->base + arena->used;
+        arena->used += size;
+        return ptr;
+    }
+    ArenaBlock *block = (ArenaBlock *)arena_malloc(ARENA_BLOCK_HEADER + size);
+    block->next = arena->overflow;
+    block->size = size;
+    arena->overflow = block;
+    arena->overflow_size += size;
+    return (unsigned char *)block + ARENA_BLOCK_HEADER;
+}
+
+void *arena_realloc(Arena *arena, void *ptr, size_t old_size, size_t new_size)
+{
+    if (!ptr)
+    {
+        return arena_alloc(arena, new_size);
+    }
+    if (arena_is_top(arena, ptr, old_size))
+    {
+        size_t offset = (size_t)((unsigned char *)ptr - arena->base);
+        if (arena_align(new_size) <= arena->capacity - offset)
+        {
+            arena->used = offset + arena_align(new_size);
+            return ptr;
+        }
+    }
+    void *new_ptr = arena_alloc(arena, new_size);
+    memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    return new_ptr;
+}
+
+void arena_pop(Arena *arena, void *ptr, size_t size)
+{
+    if (ptr && arena_is_top(arena, ptr, size))
+    {
+        arena->used = (size_t)((unsigned char *)ptr - arena->base);
+    }
+}
+
+void arena_reset(Arena *arena)
+{
+    if (arena->overflow)
+    {
+        /* Everything is dead, so the main block is replaced instead of copied */
+        size_t capacity = arena->capacity + arena->overflow_size;
+        arena_free_overflow(arena);
+        free(arena->base);
+        arena->base = (unsigned char *)arena_malloc(capacity);
+        arena->capacity = capacity;
+        arena->overflow_size = 0;
+    }
+    arena->used = 0;
+}
+
+static void *arena_vec_realloc(void *context, void *ptr, size_t old_size, size_t new_size)
+{
+    return arena_realloc((Arena *)context, ptr, old_size, new_size);
+}
+
+static void arena_vec_free(void *context, void *ptr, size_t size)
+{
+    arena_pop((Arena *)context, ptr, size);
+}
+
+VecAllocator arena_vec_allocator(Arena *arena)
+{
+    VecAllocator allocator = {arena_vec_realloc, arena_vec_free, arena};
+    return allocator;
+}
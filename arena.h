@@ -0,0 +1,101 @@
+/**
+ * @file arena.h
+ * @brief Linear bump allocator for data that only lives until the next reset.
+ *
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stddef.h>
+#include "C-Collection-Vector/vector.h"
+
+/*
+    INFO:
+        Allocations take the next ARENA_ALIGNMENT aligned bytes of one block, nothing is freed
+        one by one, arena_reset takes everything back at once. The allocation at the top of the
+        arena can still grow, shrink or be popped in place, which covers a Vec growing while nothing
+        else is allocated and scratch memory that is popped in reverse order right after use.
+        An allocation that does not fit goes to its own heap block. arena_reset frees those blocks
+        and grows the main block by their size, so once the arena has seen its largest frame,
+        allocating and resetting never touch the heap again.
+        Memory from an arena must not be used after arena_reset, Vecs backed by it are detached
+        with vec_detach first. An arena is not thread safe.
+*/
+
+/* Alignment of every allocation, enough for any scalar and for 16 byte SIMD loads */
+#define ARENA_ALIGNMENT 16
+
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct
+{
+    unsigned char *base;
+    size_t capacity;
+    size_t used;
+    size_t overflow_size; /* bytes of the overflow blocks since the last reset */
+    ArenaBlock *overflow; /* allocations that did not fit into base */
+} Arena;
+
+/**
+ * @brief Creates an arena.
+ *
+ * @param capacity Bytes of the main block, grows on arena_reset when a frame needed more.
+ * @return Arena*
+ */
+Arena *arena_new(size_t capacity);
+
+/**
+ * @brief Frees the arena and all memory allocated from it.
+ *
+ * @param arena Arena to free.
+ */
+void arena_free(Arena *arena);
+
+/**
+ * @brief Allocates memory that stays valid until the next arena_reset.
+ *
+ * @param arena Arena to allocate from.
+ * @param size Bytes to allocate.
+ * @return void* Aligned to ARENA_ALIGNMENT, not zeroed.
+ */
+void *arena_alloc(Arena *arena, size_t size);
+
+/**
+ * @brief Resizes an allocation, in place if it is at the top of the arena and still fits.
+ *
+ * @param arena Arena ptr was allocated from.
+ * @param ptr Allocation to resize, NULL allocates.
+ * @param old_size Size ptr was allocated with.
+ * @param new_size New size in bytes.
+ * @return void* ptr or a new allocation holding the first min(old_size, new_size) bytes of ptr.
+ */
+void *arena_realloc(Arena *arena, void *ptr, size_t old_size, size_t new_size);
+
+/**
+ * @brief Takes back ptr if it is at the top of the arena, otherwise it stays allocated until the next reset.
+ *
+ * @param arena Arena ptr was allocated from.
+ * @param ptr Allocation to take back.
+ * @param size Size ptr was allocated with.
+ */
+void arena_pop(Arena *arena, void *ptr, size_t size);
+
+/**
+ * @brief Takes back every allocation at once.
+ *
+ * @param arena Arena to reset.
+ *
+ * @details Frees the overflow blocks and grows the main block to hold them next time.
+ */
+void arena_reset(Arena *arena);
+
+/**
+ * @brief Returns an allocator for Vecs backed by the arena.
+ *
+ * @param arena Arena the Vecs allocate from.
+ * @return VecAllocator Pass to vec_set_allocator.
+ */
+VecAllocator arena_vec_allocator(Arena *arena);
+
+#endif
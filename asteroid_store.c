@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "asteroid_store.h"
+#include "aabb_tree.h"
+
+static void *asteroid_store_calloc(size_t count, size_t size)
+{
+    void *ptr = calloc(count, size);
+    if (!ptr)
+    {
+        fprintf(stderr, "Failed to allocate memory for asteroid store\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+AsteroidStore *asteroid_store_new(int capacity, const AsteroidShape *shapes)
+{
+    AsteroidStore *store = (AsteroidStore *)asteroid_store_calloc(1, sizeof(AsteroidStore));
+    store->capacity = capacity;
+    store->shapes = shapes;
+    store->position = (Vector2 *)asteroid_store_calloc(capacity, sizeof(Vector2));
+    store->velocity = (Vector2 *)asteroid_store_calloc(capacity, sizeof(Vector2));
+    store->angular_velocity = (float *)asteroid_store_calloc(capacity, sizeof(float));
+    store->rotation = (float *)asteroid_store_calloc(capacity, sizeof(float));
+    store->previous_position = (Vector2 *)asteroid_store_calloc(capacity, sizeof(Vector2));
+    store->previous_rotation = (float *)asteroid_store_calloc(capacity, sizeof(float));
+    store->health = (int *)asteroid_store_calloc(capacity, sizeof(int));
+    store->radius = (float *)asteroid_store_calloc(capacity, sizeof(float));
+    store->shape = (int *)asteroid_store_calloc(capacity, sizeof(int));
+    store->proxy = (int *)asteroid_store_calloc(capacity, sizeof(int));
+    store->id = (unsigned int *)asteroid_store_calloc(capacity, sizeof(unsigned int));
+    store->world = (WorldShape *)asteroid_store_calloc(capacity, sizeof(WorldShape));
+    store->color = (Color *)asteroid_store_calloc(capacity, sizeof(Color));
+    return store;
+}
+
+void asteroid_store_free(AsteroidStore *store)
+{
+    if (!store)
+        return;
+    free(store->position);
+    free(store->velocity);
+    free(store->angular_velocity);
+    free(store->rotation);
+    free(store->previous_position);
+    free(store->previous_rotation);
+    free(store->health);
+    free(store->radius);
+    free(store->shape);
+    free(store->proxy);
+    free(store->id);
+    free(store->world);
+    free(store->color);
+    free(store);
+}
+
+int asteroid_store_spawn(AsteroidStore *store)
+{
+    if (store->count >= store->capacity)
+    {
+        return -1;
+    }
+    int i = store->count++;
+    store->position[i] = (Vector2){0, 0};
+    store->velocity[i] = (Vector2){0, 0};
+    store->angular_velocity[i] = 0;
+    store->rotation[i] = 0;
+    store->previous_position[i] = (Vector2){0, 0};
+    store->previous_rotation[i] = 0;
+    store->health[i] = 0;
+    store->radius[i] = 0;
+    store->shape[i] = 0;
+    store->proxy[i] = AABB_TREE_NULL;
+    store->id[i] = store->next_id++;
+    store->color[i] = (Color){0};
+    return i;
+}
+
+void asteroid_store_despawn(AsteroidStore *store, int index)
+{
+    if (index < 0 || index >= store->count)
+    {
+        return;
+    }
+    int last = --store->count;
+    if (index == last)
+    {
+        return;
+    }
+    store->position[index] = store->position[last];
+    store->velocity[index] = store->velocity[last];
+    store->angular_velocity[index] = store->angular_velocity[last];
+    store->rotation[index] = store->rotation[last];
+    store->previous_position[index] = store->previous_position[last];
+    store->previous_rotation[index] = store->previous_rotation[last];
+    store->health[index] = store->health[last];
+    store->radius[index] = store->radius[last];
+    store->shape[index] = store->shape[last];
+    store->proxy[index] = store->proxy[last];
+    store->id[index] = store->id[last];
+    store->world[index] = store->world[last];
+    store->color[index] = store->color[last];
+}
+
+const AsteroidShape *asteroid_store_shape(const AsteroidStore *store, int index)
+{
+    return &store->shapes[store->shape[index]];
+}
@@ -0,0 +1,90 @@
+/**
+ * @file asteroid_store.h
+ * @brief Structure of arrays storage for asteroids. Every per asteroid field is its own
+ * contiguous array, shapes are indices into a shared AsteroidShapeBank.
+ *
+ */
+
+#ifndef ASTEROID_STORE_H_
+#define ASTEROID_STORE_H_
+
+#include <raylib.h>
+#include "collision.h"
+#include "shape.h"
+
+/*
+    INFO:
+        Asteroids are dense, index i of every array belongs to the same asteroid and [0, count) is alive.
+        Despawning moves the last asteroid into the freed index, so anything the caller keys by index
+        (tree user ids, pair lists) has to be updated for the moved asteroid. id never changes.
+        All memory is allocated by asteroid_store_new, spawning and despawning never allocate.
+        Shapes are shared and never written through the store, any number of asteroids can use the same one.
+*/
+
+typedef struct
+{
+    int count;
+    int capacity;
+    Vector2 *position;
+    Vector2 *velocity;
+    float *angular_velocity;
+    float *rotation;
+    Vector2 *previous_position; /* position and rotation at the start of the last tick, for render interpolation */
+    float *previous_rotation;
+    int *health;
+    float *radius;
+    int *shape;        /* index in shapes */
+    int *proxy;        /* leaf in the broad-phase tree */
+    unsigned int *id;  /* stable id, kept when the asteroid moves to another index */
+    WorldShape *world; /* world space hitshape, refreshed once per tick */
+    Color *color;
+    const AsteroidShape *shapes; /* not owned */
+    unsigned int next_id;
+} AsteroidStore;
+
+/**
+ * @brief Allocates every array of the store up front.
+ *
+ * @param capacity Maximum number of asteroids alive at once.
+ * @param shapes Shapes the asteroids index into, must outlive the store.
+ * @return AsteroidStore*
+ */
+AsteroidStore *asteroid_store_new(int capacity, const AsteroidShape *shapes);
+
+/**
+ * @brief Frees the store and all of its arrays.
+ *
+ * @param store Store to free.
+ */
+void asteroid_store_free(AsteroidStore *store);
+
+/**
+ * @brief Appends a zeroed asteroid using shape 0.
+ *
+ * @param store Store to spawn into.
+ * @return int Index of the new asteroid, -1 if the store is full.
+ *
+ * @details O(1). proxy is set to AABB_TREE_NULL and the asteroid gets a new id.
+ */
+int asteroid_store_spawn(AsteroidStore *store);
+
+/**
+ * @brief Removes an asteroid.
+ *
+ * @param store Store to despawn from.
+ * @param index Index of the asteroid.
+ *
+ * @details O(1). The last asteroid is moved into index.
+ */
+void asteroid_store_despawn(AsteroidStore *store, int index);
+
+/**
+ * @brief Returns the shared shape of an asteroid.
+ *
+ * @param store Store containing the asteroid.
+ * @param index Index of the asteroid.
+ * @return const AsteroidShape*
+ */
+const AsteroidShape *asteroid_store_shape(const AsteroidStore *store, int index);
+
+#endif
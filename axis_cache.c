@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "axis_cache.h"
+
+static void *axis_cache_calloc(size_t count, size_t size)
+{
+    void *ptr = calloc(count, size);
+    if (!ptr)
+    {
+        fprintf(stderr, "Failed to allocate memory for axis cache\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+static unsigned long long axis_cache_key(unsigned int id0, unsigned int id1)
+{
+    unsigned int low = id0 < id1 ? id0 : id1;
+    unsigned int high = id0 < id1 ? id1 : id0;
+    return ((unsigned long long)low << 32) | high;
+}
+
+static int axis_cache_slot(const AxisCache *cache, unsigned long long key)
+{
+    /* Fibonacci hashing, the high bits are the best mixed */
+    return (int)((key * 0x9E3779B97F4A7C15ull) >> 32) & (cache->capacity - 1);
+}
+
+AxisCache *axis_cache_new(int capacity)
+{
+    AxisCache *cache = (AxisCache *)axis_cache_calloc(1, sizeof(AxisCache));
+    cache->capacity = 1;
+    while (cache->capacity < capacity)
+    {
+        cache->capacity *= 2;
+    }
+    cache->tables[0] = (AxisCacheEntry *)axis_cache_calloc(cache->capacity, sizeof(AxisCacheEntry));
+    cache->tables[1] = (AxisCacheEntry *)axis_cache_calloc(cache->capacity, sizeof(AxisCacheEntry));
+    /* Every slot starts with stamp 0, the first step is 2 so neither table has a valid slot */
+    cache->stamp = 2;
+    return cache;
+}
+
+void axis_cache_free(AxisCache *cache)
+{
+    if (!cache)
+        return;
+    free(cache->tables[0]);
+    free(cache->tables[1]);
+    free(cache);
+}
+
+void axis_cache_advance(AxisCache *cache)
+{
+    cache->stamp++;
+}
+
+bool axis_cache_find(const AxisCache *cache, unsigned int id0, unsigned int id1, Vector2 *axis)
+{
+    unsigned int stamp = cache->stamp - 1;
+    const AxisCacheEntry *table = cache->tables[stamp & 1];
+    unsigned long long key = axis_cache_key(id0, id1);
+    int slot = axis_cache_slot(cache, key);
+    int i;
+    for (i = 0; i < AXIS_CACHE_MAX_PROBES; i++)
+    {
+        const AxisCacheEntry *entry = &table[(slot + i) & (cache->capacity - 1)];
+        if (entry->stamp != stamp)
+        {
+            return false;
+        }
+        if (entry->key == key)
+        {
+            *axis = entry->axis;
+            return true;
+        }
+    }
+    return false;
+}
+
+void axis_cache_store(AxisCache *cache, unsigned int id0, unsigned int id1, Vector2 axis)
+{
+    AxisCacheEntry *table = cache->tables[cache->stamp & 1];
+    unsigned long long key = axis_cache_key(id0, id1);
+    int slot = axis_cache_slot(cache, key);
+    int i;
+    for (i = 0; i < AXIS_CACHE_MAX_PROBES; i++)
+    {
+        AxisCacheEntry *entry = &table[(slot + i) & (cache->capacity - 1)];
+        if (entry->stamp != cache->stamp || entry->key == key)
+        {
+            entry->key = key;
+            entry->axis = axis;
+            entry->stamp = cache->stamp;
+            return;
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/**
+ * @file axis_cache.h
+ * @brief Per pair cache of the last separating or MTV axis, keyed by the stable ids of both entities.
+ * Bodies move little between ticks, so last tick's separating axis usually still separates the pair.
+ *
+ */
+
+#ifndef AXIS_CACHE_H_
+#define AXIS_CACHE_H_
+
+#include <stdbool.h>
+#include <raylib.h>
+
+/*
+    INFO:
+        Two fixed size open addressing tables are used in turns. During a step axis_cache_find reads the
+        table written in the previous step and axis_cache_store writes the other one, so only pairs that
+        were candidates in the previous step can be found and every other pair is evicted without any
+        cleanup. Slots belong to a step by their stamp, advancing the step makes the older table empty.
+        Memory never grows, a pair that finds no free slot within AXIS_CACHE_MAX_PROBES is not cached.
+        axis_cache_find only reads, so it can be called from every worker while nobody stores.
+*/
+
+/* Linear probing gives up after this many slots */
+#define AXIS_CACHE_MAX_PROBES 16
+
+typedef struct
+{
+    unsigned long long key; /* both ids, smaller one in the high half */
+    Vector2 axis;
+    unsigned int stamp; /* step that wrote the slot, any other value means empty */
+} AxisCacheEntry;
+
+typedef struct
+{
+    AxisCacheEntry *tables[2]; /* tables[stamp & 1] is written in step stamp */
+    int capacity;              /* slots per table, a power of two */
+    unsigned int stamp;
+} AxisCache;
+
+/**
+ * @brief Allocates both tables.
+ *
+ * @param capacity Slots per table, rounded up to a power of two.
+ * @return AxisCache*
+ */
+AxisCache *axis_cache_new(int capacity);
+
+/**
+ * @brief Frees the cache and its tables.
+ *
+ * @param cache Cache to free.
+ */
+void axis_cache_free(AxisCache *cache);
+
+/**
+ * @brief Starts a new step, the axes stored in the current step become the ones axis_cache_find returns.
+ *
+ * @param cache Cache to advance.
+ */
+void axis_cache_advance(AxisCache *cache);
+
+/**
+ * @brief Looks up the axis a pair stored in the previous step.
+ *
+ * @param cache Cache to search.
+ * @param id0 Stable id of one entity.
+ * @param id1 Stable id of the other entity, the order of the ids does not matter.
+ * @param axis Set to the cached axis if found.
+ * @return true if the pair was found.
+ */
+bool axis_cache_find(const AxisCache *cache, unsigned int id0, unsigned int id1, Vector2 *axis);
+
+/**
+ * @brief Stores the axis of a pair for the next step.
+ *
+ * @param cache Cache to store into.
+ * @param id0 Stable id of one entity.
+ * @param id1 Stable id of the other entity.
+ * @param axis Separating axis, or the MTV axis if the pair touches.
+ */
+void axis_cache_store(AxisCache *cache, unsigned int id0, unsigned int id1, Vector2 axis);
+
+#endif
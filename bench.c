@@ -0,0 +1,730 @@
+/**
+ * @file bench.c
+ * @brief Microbenchmarks for the collision primitives and the Vec operations run every tick.
+ *
+ * Usage: Bench [--filter text] [--samples n] [--json path]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <raylib.h>
+#include <raymath.h>
+#include "C-Collection-Vector/vector.h"
+#include "collision.h"
+#include "asteroid_store.h"
+#include "world.h"
+#include "render.h"
+#include "snapshot.h"
+#include "world_query.h"
+#include "integrate.h"
+
+/*
+    INFO:
+        Every benchmark runs its body `iterations` times per sample. The iteration count is doubled
+        until one sample takes at least BENCH_MIN_SAMPLE_NS, then BENCH_DEFAULT_SAMPLES samples are timed.
+        setup runs before every sample and is not timed, so benchmarks that consume their input
+        (vec_remove_fast) can refill it.
+        Results are printed as a table and, with --json, written as one object per benchmark.
+*/
+
+#define BENCH_DEFAULT_SAMPLES 20
+#define BENCH_MIN_SAMPLE_NS 10000000.0
+#define BENCH_MAX_ITERATIONS (1L << 28)
+#define BENCH_VEC_SIZE 1024
+#define BENCH_SORT_KEY_SIZE 16384
+#define BENCH_SHIP_POINTS 3
+#define BENCH_RENDER_ASTEROIDS 200
+#define BENCH_STEP_ASTEROIDS 400
+#define BENCH_INTEGRATE_COUNT 4096
+#define BENCH_SNAPSHOT_ASTEROIDS 100000
+/* Written by bench_init and removed again by bench_shutdown */
+#define BENCH_SNAPSHOT_PATH "bench_snapshot.snap"
+
+typedef struct
+{
+    const char *name;
+    void (*setup)(long iterations); /* can be NULL */
+    void (*run)(long iterations);
+    const CollisionStats *(*stats)(void); /* narrow phase counters of the last op, can be NULL */
+} Benchmark;
+
+typedef struct
+{
+    const char *name;
+    long iterations;
+    int samples;
+    double mean_ns;
+    double min_ns;
+    double max_ns;
+    double variance_ns;
+    double ops_per_sec;
+    bool has_stats;
+    CollisionStats stats;
+} BenchResult;
+
+/* Results are written here so the compiler cannot drop the benchmarked calls */
+static volatile float bench_sink;
+static time_t bench_epoch;
+
+static Vector2 ship_points[BENCH_SHIP_POINTS];
+static AsteroidShape asteroid_shapes[2];
+static AsteroidStore *collision_store;
+static Vec *bench_vec;
+static int sort_source[BENCH_VEC_SIZE];
+static Vec *sort_key_vec;
+static Contact sort_key_source[BENCH_SORT_KEY_SIZE];
+static World *render_world_state;
+static World *step_world;
+static Vec *query_hit_vec;
+static Vector2 integrate_position[BENCH_INTEGRATE_COUNT];
+static Vector2 integrate_velocity[BENCH_INTEGRATE_COUNT];
+static float integrate_rotation[BENCH_INTEGRATE_COUNT];
+static float integrate_angular_velocity[BENCH_INTEGRATE_COUNT];
+static Vec *integrate_wrapped_vec;
+static LineBatch *render_batch;
+
+static double bench_now_ns(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)(ts.tv_sec - bench_epoch) * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Deterministic outline in the same layout the world's shape bank holds */
+static void bench_asteroid_shape(AsteroidShape *shape, float asteroid_radius, unsigned int seed)
+{
+    int i;
+    for (i = 0; i < ASTEROID_POINTS; i++)
+    {
+        float angle = (float)i / ASTEROID_POINTS * 2 * PI;
+        seed = seed * 1103515245u + 12345u;
+        float radius = asteroid_radius * 0.5f + ((float)((seed >> 16) % 51) / 100.0f) * asteroid_radius;
+        shape->outline[i] = (Vector2){cosf(angle) * radius, sinf(angle) * radius};
+    }
+    asteroid_shape_finish(shape);
+}
+
+static void bench_init(void)
+{
+    ship_points[0] = (Vector2){-10, -2};
+    ship_points[1] = (Vector2){10, -2};
+    ship_points[2] = (Vector2){0, 18};
+    bench_asteroid_shape(&asteroid_shapes[0], ASTEROID_RADIUS_BIG, 1);
+    bench_asteroid_shape(&asteroid_shapes[1], ASTEROID_RADIUS_BIG, 2);
+    collision_store = asteroid_store_new(2, asteroid_shapes);
+    asteroid_store_spawn(collision_store);
+    asteroid_store_spawn(collision_store);
+    bench_vec = VEC(int);
+    bench_vec->cmp = vec_int_cmp;
+    unsigned int seed = 7;
+    int i;
+    for (i = 0; i < BENCH_VEC_SIZE; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        sort_source[i] = (int)(seed >> 8);
+    }
+    sort_key_vec = contact_vec_new(BENCH_SORT_KEY_SIZE);
+    for (i = 0; i < BENCH_SORT_KEY_SIZE; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        sort_key_source[i] = (Contact){(int)(seed >> 8), {0, 0}, 0};
+    }
+    render_world_state = world_new((Vector2){800, 450}, 1, 1);
+    for (i = 0; i < BENCH_RENDER_ASTEROIDS; i++)
+    {
+        asteroid_spawn(render_world_state, ASTEROID_RADIUS_BIG, (Vector2){world_random_value(render_world_state, 0, 800), world_random_value(render_world_state, 0, 450)}, (Vector2){1, 1});
+    }
+    render_batch = line_batch_new();
+    step_world = world_new((Vector2){1600, 900}, 1, 1);
+    for (i = 0; i < BENCH_STEP_ASTEROIDS; i++)
+    {
+        asteroid_spawn(step_world, ASTEROID_RADIUS_MEDIUM, (Vector2){world_random_value(step_world, 0, 1600), world_random_value(step_world, 0, 900)}, (Vector2){world_random_value(step_world, -2, 2), world_random_value(step_world, -2, 2)});
+    }
+    query_hit_vec = world_segment_hit_vec_new(VECTOR_DEFAULT_CAP);
+    for (i = 0; i < BENCH_INTEGRATE_COUNT; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        integrate_position[i] = (Vector2){(float)(seed >> 8 & 1023), (float)(seed >> 18 & 511)};
+        integrate_velocity[i] = (Vector2){(float)(seed & 7) - 3.5f, (float)(seed >> 3 & 7) - 3.5f};
+        integrate_angular_velocity[i] = (float)(seed >> 6 & 63);
+    }
+    integrate_wrapped_vec = VEC(int);
+    World *snapshot_world = world_new_empty((Vector2){16000, 9000}, 1, 1, BENCH_SNAPSHOT_ASTEROIDS);
+    world_add_asteroids(snapshot_world, BENCH_SNAPSHOT_ASTEROIDS);
+    if (!snapshot_save(snapshot_world, BENCH_SNAPSHOT_PATH))
+    {
+        exit(1);
+    }
+    world_free(snapshot_world);
+}
+
+static void bench_shutdown(void)
+{
+    asteroid_store_free(collision_store);
+    vec_free(bench_vec);
+    vec_free(sort_key_vec);
+    world_free(render_world_state);
+    line_batch_free(render_batch);
+    world_free(step_world);
+    vec_free(query_hit_vec);
+    vec_free(integrate_wrapped_vec);
+    remove(BENCH_SNAPSHOT_PATH);
+}
+
+/* Hit cases overlap by a few units, miss cases are far enough apart for the first axis to separate them */
+#define BENCH_HIT_OFFSET ((Vector2){20, 10})
+#define BENCH_MISS_OFFSET ((Vector2){200, 100})
+
+#define BENCH_SAT(fn_name, shape_a, count_a, shape_b, count_b, offset)                                                \
+    static void fn_name(long iterations)                                                                              \
+    {                                                                                                                 \
+        Vector2 position_a = {100, 100};                                                                              \
+        Vector2 position_b = Vector2Add(position_a, offset);                                                          \
+        Vector2 mtv;                                                                                                  \
+        int hits = 0;                                                                                                 \
+        long i;                                                                                                       \
+        for (i = 0; i < iterations; i++)                                                                              \
+        {                                                                                                             \
+            hits += sat_collision(shape_a, count_a, position_a, 30.0f + (float)(i & 7), shape_b, count_b, position_b, \
+                                  75.0f, &mtv);                                                                       \
+        }                                                                                                             \
+        bench_sink = (float)hits + mtv.x;                                                                             \
+    }
+
+BENCH_SAT(bench_sat_3v11_hit, ship_points, BENCH_SHIP_POINTS, asteroid_shapes[1].outline, ASTEROID_POINTS, BENCH_HIT_OFFSET)
+BENCH_SAT(bench_sat_3v11_miss, ship_points, BENCH_SHIP_POINTS, asteroid_shapes[1].outline, ASTEROID_POINTS, BENCH_MISS_OFFSET)
+BENCH_SAT(bench_sat_4v4_hit, asteroid_shapes[0].hitshape, ASTEROID_HITSHAPE_POINTS, asteroid_shapes[1].hitshape, ASTEROID_HITSHAPE_POINTS, BENCH_HIT_OFFSET)
+BENCH_SAT(bench_sat_4v4_miss, asteroid_shapes[0].hitshape, ASTEROID_HITSHAPE_POINTS, asteroid_shapes[1].hitshape, ASTEROID_HITSHAPE_POINTS, BENCH_MISS_OFFSET)
+BENCH_SAT(bench_sat_4v11_hit, asteroid_shapes[0].hitshape, ASTEROID_HITSHAPE_POINTS, asteroid_shapes[1].outline, ASTEROID_POINTS, BENCH_HIT_OFFSET)
+BENCH_SAT(bench_sat_4v11_miss, asteroid_shapes[0].hitshape, ASTEROID_HITSHAPE_POINTS, asteroid_shapes[1].outline, ASTEROID_POINTS, BENCH_MISS_OFFSET)
+
+/* Projectile box crossing a whole big asteroid hitshape within one step, the case discrete tests miss */
+static void bench_sat_sweep_4v4(long iterations)
+{
+    static const Vector2 box[4] = {{-2, -2}, {2, -2}, {2, 2}, {-2, 2}};
+    WorldShape projectile, asteroid;
+    SatSweep sweep = {0};
+    int hits = 0;
+    long i;
+    world_shape_update(&projectile, box, 4, (Vector2){60, 100}, 0);
+    world_shape_update(&asteroid, asteroid_shapes[0].hitshape, ASTEROID_HITSHAPE_POINTS, (Vector2){100, 100}, 30.0f);
+    for (i = 0; i < iterations; i++)
+    {
+        hits += sat_sweep_cached(&projectile, &asteroid, (Vector2){80.0f + (float)(i & 7), 1.0f}, &sweep);
+    }
+    bench_sink = (float)hits + sweep.toi;
+}
+
+static void bench_project_onto_vector(long iterations)
+{
+    float sum = 0;
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        float min, max;
+        Vector2 axis = (i & 1) ? (Vector2){0.6f, 0.8f} : (Vector2){0.8f, -0.6f};
+        project_onto_vector(asteroid_shapes[0].outline, ASTEROID_POINTS, (Vector2){100, 100}, 45.0f, axis, &min, &max);
+        sum += max - min;
+    }
+    bench_sink = sum;
+}
+
+static void bench_point_in_polygon(long iterations)
+{
+    int inside = 0;
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        /* Alternates between a point inside and one outside the outline */
+        Vector2 point = (i & 1) ? (Vector2){102, 101} : (Vector2){160, 160};
+        inside += point_in_polygon(asteroid_shapes[0].outline, ASTEROID_POINTS, (Vector2){100, 100}, 45.0f, point);
+    }
+    bench_sink = (float)inside;
+}
+
+static void bench_handle_asteroid_collision_setup(long iterations)
+{
+    (void)iterations;
+    collision_store->position[0] = (Vector2){100, 100};
+    collision_store->position[1] = (Vector2){130, 110};
+    collision_store->velocity[0] = (Vector2){1, 0.5f};
+    collision_store->velocity[1] = (Vector2){-1, 0};
+    collision_store->angular_velocity[0] = 0;
+    collision_store->angular_velocity[1] = 0;
+    collision_store->radius[0] = ASTEROID_RADIUS_BIG;
+    collision_store->radius[1] = ASTEROID_RADIUS_MEDIUM;
+}
+
+static void bench_handle_asteroid_collision(long iterations)
+{
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        handle_asteroid_collision(collision_store, 0, 1, (Vector2){-0.3f, -0.1f});
+    }
+    bench_sink = collision_store->velocity[0].x;
+}
+
+static void bench_vec_push_back_setup(long iterations)
+{
+    (void)iterations;
+    vec_clear(bench_vec);
+}
+
+/* Pushes into a Vec that is cleared every BENCH_VEC_SIZE entries, like the per tick pair Vecs */
+static void bench_vec_push_back(long iterations)
+{
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        int value = (int)i;
+        if (vec_size(bench_vec) == BENCH_VEC_SIZE)
+        {
+            bench_vec->len = 0;
+        }
+        vec_push_back(bench_vec, &value);
+    }
+    bench_sink = (float)vec_size(bench_vec);
+}
+
+/* Same as bench_vec_push_back through the inlined VEC_DEFINE functions */
+static void bench_int_vec_push_back(long iterations)
+{
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        int value = (int)i;
+        if (int_vec_size(bench_vec) == BENCH_VEC_SIZE)
+        {
+            bench_vec->len = 0;
+        }
+        int_vec_push_back(bench_vec, &value);
+    }
+    bench_sink = (float)int_vec_size(bench_vec);
+}
+
+static void bench_vec_remove_fast_setup(long iterations)
+{
+    vec_clear(bench_vec);
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        int value = (int)i;
+        vec_push_back(bench_vec, &value);
+    }
+}
+
+static void bench_vec_remove_fast(long iterations)
+{
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        vec_remove_fast(bench_vec, (size_t)(i & (BENCH_VEC_SIZE - 1)) % vec_size(bench_vec));
+    }
+    bench_sink = (float)vec_size(bench_vec);
+}
+
+static void bench_int_vec_remove_fast(long iterations)
+{
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        int_vec_remove_fast(bench_vec, (size_t)(i & (BENCH_VEC_SIZE - 1)) % int_vec_size(bench_vec));
+    }
+    bench_sink = (float)int_vec_size(bench_vec);
+}
+
+static void bench_vec_at_setup(long iterations)
+{
+    (void)iterations;
+    vec_clear(bench_vec);
+    int i;
+    for (i = 0; i < BENCH_VEC_SIZE; i++)
+    {
+        vec_push_back(bench_vec, &sort_source[i]);
+    }
+}
+
+static void bench_vec_at(long iterations)
+{
+    unsigned int sum = 0;
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        sum += (unsigned int)*(int *)vec_at(bench_vec, (size_t)(i & (BENCH_VEC_SIZE - 1)));
+    }
+    bench_sink = (float)sum;
+}
+
+static void bench_int_vec_at(long iterations)
+{
+    unsigned int sum = 0;
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        sum += (unsigned int)*int_vec_at(bench_vec, (size_t)(i & (BENCH_VEC_SIZE - 1)));
+    }
+    bench_sink = (float)sum;
+}
+
+/* One op sorts BENCH_VEC_SIZE ints, refilling them from sort_source is part of the op */
+static void bench_vec_sort(long iterations)
+{
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        memcpy(bench_vec->data, sort_source, sizeof(sort_source));
+        vec_sort(bench_vec);
+    }
+    bench_sink = (float)*(int *)vec_at(bench_vec, 0);
+}
+
+/* Same as bench_vec_sort through qsort, the path vec_sort took for every cmp */
+static void bench_vec_qsort(long iterations)
+{
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        memcpy(bench_vec->data, sort_source, sizeof(sort_source));
+        qsort(bench_vec->data, BENCH_VEC_SIZE, sizeof(int), vec_int_cmp);
+    }
+    bench_sink = (float)*(int *)vec_at(bench_vec, 0);
+}
+
+static int bench_contact_cmp(const void *data0, const void *data1)
+{
+    const Contact *contact0 = (const Contact *)data0;
+    const Contact *contact1 = (const Contact *)data1;
+    return (contact0->pair > contact1->pair) - (contact0->pair < contact1->pair);
+}
+
+/* One op sorts BENCH_SORT_KEY_SIZE contacts by pair, like the merged contacts of a crowded tick */
+static void bench_vec_sort_by_key(long iterations)
+{
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        contact_vec_clear(sort_key_vec);
+        vec_push_back_n(sort_key_vec, sort_key_source, BENCH_SORT_KEY_SIZE);
+        vec_sort_by_key(sort_key_vec, offsetof(Contact, pair), VEC_KEY_INT32);
+    }
+    bench_sink = (float)contact_vec_at(sort_key_vec, 0)->pair;
+}
+
+static void bench_qsort_by_key(long iterations)
+{
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        contact_vec_clear(sort_key_vec);
+        vec_push_back_n(sort_key_vec, sort_key_source, BENCH_SORT_KEY_SIZE);
+        qsort(sort_key_vec->data, BENCH_SORT_KEY_SIZE, sizeof(Contact), bench_contact_cmp);
+    }
+    bench_sink = (float)contact_vec_at(sort_key_vec, 0)->pair;
+}
+
+static int bench_int_is_odd(const void *entry, void *context)
+{
+    (void)context;
+    return *(const int *)entry & 1;
+}
+
+/* One op refills BENCH_VEC_SIZE ints from sort_source and removes the odd ones, about half */
+static void bench_vec_remove_if(long iterations)
+{
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        bench_vec->len = 0;
+        vec_push_back_n(bench_vec, sort_source, BENCH_VEC_SIZE);
+        vec_remove_if(bench_vec, bench_int_is_odd, NULL);
+    }
+    bench_sink = (float)vec_size(bench_vec);
+}
+
+/* Spawn path of a split piece, the asteroid is despawned again so the store never fills */
+static void bench_asteroid_spawn(long iterations)
+{
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        int index = asteroid_spawn(render_world_state, ASTEROID_RADIUS_MEDIUM, (Vector2){100, 100}, (Vector2){1, 1});
+        asteroid_store_despawn(render_world_state->asteroids, index);
+    }
+    bench_sink = (float)render_world_state->asteroids->count;
+}
+
+/* One op moves, wraps and clamps BENCH_INTEGRATE_COUNT entities, the entities keep moving between samples */
+static void bench_integrate_wrap(long iterations)
+{
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        integrate_wrap(integrate_position, integrate_velocity, integrate_rotation, integrate_angular_velocity, BENCH_INTEGRATE_COUNT,
+                       100.0f / 60.0f, 1.0f / 60.0f, (Vector2){1024, 512}, (Vector2){2, 2}, integrate_wrapped_vec);
+    }
+    bench_sink = (float)vec_size(integrate_wrapped_vec);
+}
+
+static void bench_integrate_wrap_scalar(long iterations)
+{
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        integrate_wrap_scalar(integrate_position, integrate_velocity, integrate_rotation, integrate_angular_velocity, BENCH_INTEGRATE_COUNT,
+                              100.0f / 60.0f, 1.0f / 60.0f, (Vector2){1024, 512}, (Vector2){2, 2}, integrate_wrapped_vec);
+    }
+    bench_sink = (float)vec_size(integrate_wrapped_vec);
+}
+
+/* One op builds the vertices of a whole frame */
+static void bench_render_world(long iterations)
+{
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        line_batch_clear(render_batch);
+        render_world(render_batch, render_world_state, 0.5f, true);
+    }
+    bench_sink = (float)render_batch->count;
+}
+
+/* One op is a whole tick, the world keeps evolving between samples */
+static void bench_world_step(long iterations)
+{
+    WorldInputs inputs = {0};
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        world_begin_frame(step_world);
+        world_step(step_world, 1.0f / 60.0f, &inputs);
+    }
+    bench_sink = (float)step_world->asteroids->count;
+}
+
+/* The asteroid tree is only filled by a step */
+static void bench_world_query_setup(long iterations)
+{
+    (void)iterations;
+    WorldInputs inputs = {0};
+    world_begin_frame(step_world);
+    world_step(step_world, 1.0f / 60.0f, &inputs);
+}
+
+/* One op is a point query, the points walk over the whole field */
+static void bench_world_query_point(long iterations)
+{
+    long i;
+    int hits = 0;
+    for (i = 0; i < iterations; i++)
+    {
+        Vector2 point = {(float)(i * 37 % 1600), (float)(i * 23 % 900)};
+        hits += world_query_point(step_world, point) >= 0;
+    }
+    bench_sink = (float)hits;
+}
+
+/* One op collects every asteroid along a segment a fifth of the field long */
+static void bench_world_query_segment(long iterations)
+{
+    long i;
+    size_t hits = 0;
+    for (i = 0; i < iterations; i++)
+    {
+        Vector2 start = {(float)(i * 37 % 1600), (float)(i * 23 % 900)};
+        world_query_segment_all(step_world, start, Vector2Add(start, (Vector2){320, 180}), query_hit_vec);
+        hits += world_segment_hit_vec_size(query_hit_vec);
+    }
+    bench_sink = (float)hits;
+}
+
+/* One op maps the snapshot and builds a world from it, the world is freed again */
+static void bench_snapshot_load(long iterations)
+{
+    long i;
+    for (i = 0; i < iterations; i++)
+    {
+        Snapshot *snapshot = snapshot_open(BENCH_SNAPSHOT_PATH);
+        World *world = snapshot_load(snapshot, 1);
+        snapshot_close(snapshot);
+        bench_sink = (float)world->asteroids->count;
+        world_free(world);
+    }
+}
+
+static const CollisionStats *bench_world_step_stats(void)
+{
+    return &step_world->collision_stats;
+}
+
+static const Benchmark benchmarks[] = {
+    {"sat_collision_3v11_hit", NULL, bench_sat_3v11_hit, NULL},
+    {"sat_collision_3v11_miss", NULL, bench_sat_3v11_miss, NULL},
+    {"sat_collision_4v4_hit", NULL, bench_sat_4v4_hit, NULL},
+    {"sat_collision_4v4_miss", NULL, bench_sat_4v4_miss, NULL},
+    {"sat_collision_4v11_hit", NULL, bench_sat_4v11_hit, NULL},
+    {"sat_collision_4v11_miss", NULL, bench_sat_4v11_miss, NULL},
+    {"sat_sweep_4v4", NULL, bench_sat_sweep_4v4, NULL},
+    {"project_onto_vector_11", NULL, bench_project_onto_vector, NULL},
+    {"point_in_polygon_11", NULL, bench_point_in_polygon, NULL},
+    {"handle_asteroid_collision", bench_handle_asteroid_collision_setup, bench_handle_asteroid_collision, NULL},
+    {"vec_push_back", bench_vec_push_back_setup, bench_vec_push_back, NULL},
+    {"vec_remove_fast", bench_vec_remove_fast_setup, bench_vec_remove_fast, NULL},
+    {"vec_at", bench_vec_at_setup, bench_vec_at, NULL},
+    {"int_vec_push_back", bench_vec_push_back_setup, bench_int_vec_push_back, NULL},
+    {"int_vec_remove_fast", bench_vec_remove_fast_setup, bench_int_vec_remove_fast, NULL},
+    {"int_vec_at", bench_vec_at_setup, bench_int_vec_at, NULL},
+    {"vec_sort_1024", bench_vec_at_setup, bench_vec_sort, NULL},
+    {"vec_qsort_1024", bench_vec_at_setup, bench_vec_qsort, NULL},
+    {"vec_sort_by_key_16k", NULL, bench_vec_sort_by_key, NULL},
+    {"vec_qsort_by_key_16k", NULL, bench_qsort_by_key, NULL},
+    {"vec_remove_if_1024", bench_vec_at_setup, bench_vec_remove_if, NULL},
+    {"asteroid_spawn", NULL, bench_asteroid_spawn, NULL},
+    {"integrate_wrap_4096", NULL, bench_integrate_wrap, NULL},
+    {"integrate_wrap_scalar_4096", NULL, bench_integrate_wrap_scalar, NULL},
+    {"render_world_200", NULL, bench_render_world, NULL},
+    {"world_step_400", NULL, bench_world_step, bench_world_step_stats},
+    {"world_query_point_400", bench_world_query_setup, bench_world_query_point, NULL},
+    {"world_query_segment_400", bench_world_query_setup, bench_world_query_segment, NULL},
+    {"snapshot_load_100k", NULL, bench_snapshot_load, NULL},
+};
+
+static double bench_sample(const Benchmark *benchmark, long iterations)
+{
+    if (benchmark->setup)
+    {
+        benchmark->setup(iterations);
+    }
+    double start = bench_now_ns();
+    benchmark->run(iterations);
+    return bench_now_ns() - start;
+}
+
+static BenchResult bench_run(const Benchmark *benchmark, int samples)
+{
+    BenchResult result = {0};
+    result.name = benchmark->name;
+    long iterations = 1;
+    while (iterations < BENCH_MAX_ITERATIONS && bench_sample(benchmark, iterations) < BENCH_MIN_SAMPLE_NS)
+    {
+        iterations *= 2;
+    }
+    double sum = 0, sum_sq = 0;
+    result.min_ns = INFINITY;
+    result.max_ns = 0;
+    int i;
+    for (i = 0; i < samples; i++)
+    {
+        double ns = bench_sample(benchmark, iterations) / (double)iterations;
+        sum += ns;
+        sum_sq += ns * ns;
+        result.min_ns = fmin(result.min_ns, ns);
+        result.max_ns = fmax(result.max_ns, ns);
+    }
+    result.iterations = iterations;
+    result.samples = samples;
+    result.mean_ns = sum / samples;
+    result.variance_ns = samples > 1 ? fmax(0.0, (sum_sq - sum * sum / samples) / (samples - 1)) : 0.0;
+    result.ops_per_sec = result.mean_ns > 0 ? 1e9 / result.mean_ns : 0.0;
+    if (benchmark->stats)
+    {
+        result.has_stats = true;
+        result.stats = *benchmark->stats();
+    }
+    return result;
+}
+
+static void bench_write_json(FILE *file, BenchResult *results, int count)
+{
+    int i;
+    fprintf(file, "{\n  \"benchmarks\": [\n");
+    for (i = 0; i < count; i++)
+    {
+        BenchResult *r = &results[i];
+        fprintf(file,
+                "    {\"name\": \"%s\", \"iterations\": %ld, \"samples\": %d, \"ns_per_op\": %.4f, \"min_ns_per_op\": %.4f, "
+                "\"max_ns_per_op\": %.4f, \"variance_ns2\": %.6f, \"stddev_ns\": %.4f, \"ops_per_sec\": %.1f",
+                r->name, r->iterations, r->samples, r->mean_ns, r->min_ns, r->max_ns, r->variance_ns, sqrt(r->variance_ns),
+                r->ops_per_sec);
+        if (r->has_stats)
+        {
+            fprintf(file, ", \"narrow_phase\": {\"pairs\": %u, \"circle_rejects\": %u, \"aabb_rejects\": %u, \"sat_rejects\": %u, \"cached_axis_rejects\": %u, \"hits\": %u}",
+                    r->stats.pairs, r->stats.circle_rejects, r->stats.aabb_rejects, r->stats.sat_rejects, r->stats.cached_axis_rejects, r->stats.hits);
+        }
+        fprintf(file, "}%s\n", i + 1 < count ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *filter = NULL;
+    const char *json_path = NULL;
+    int samples = BENCH_DEFAULT_SAMPLES;
+    int i;
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--filter") && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--samples") && i + 1 < argc)
+        {
+            samples = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--json") && i + 1 < argc)
+        {
+            json_path = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--filter text] [--samples n] [--json path]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (samples < 1)
+    {
+        samples = 1;
+    }
+    bench_epoch = time(NULL);
+    bench_init();
+
+    int benchmark_count = (int)(sizeof(benchmarks) / sizeof(benchmarks[0]));
+    BenchResult results[sizeof(benchmarks) / sizeof(benchmarks[0])];
+    int result_count = 0;
+    printf("%-28s %12s %12s %12s %16s\n", "benchmark", "ns/op", "stddev", "min", "ops/s");
+    for (i = 0; i < benchmark_count; i++)
+    {
+        if (filter && !strstr(benchmarks[i].name, filter))
+        {
+            continue;
+        }
+        BenchResult *r = &results[result_count++];
+        *r = bench_run(&benchmarks[i], samples);
+        printf("%-28s %12.2f %12.2f %12.2f %16.0f\n", r->name, r->mean_ns, sqrt(r->variance_ns), r->min_ns, r->ops_per_sec);
+        if (r->has_stats)
+        {
+            printf("  narrow phase of last op: %u pairs, rejected circle %u aabb %u sat %u (cached axis %u), hits %u\n", r->stats.pairs,
+                   r->stats.circle_rejects, r->stats.aabb_rejects, r->stats.sat_rejects, r->stats.cached_axis_rejects, r->stats.hits);
+        }
+    }
+
+    if (json_path)
+    {
+        FILE *file = fopen(json_path, "w");
+        if (!file)
+        {
+            fprintf(stderr, "Failed to open %s\n", json_path);
+            bench_shutdown();
+            return 1;
+        }
+        bench_write_json(file, results, result_count);
+        fclose(file);
+    }
+    bench_shutdown();
+    return 0;
+}
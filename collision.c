@@ -0,0 +1,645 @@
+#include <raylib.h>
+#include <raymath.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include "collision.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SAT_SIMD_WIDTH 8
+typedef __m256 sat_vf;
+#define SAT_LOAD(p) _mm256_loadu_ps(p)
+#define SAT_STORE(p, v) _mm256_storeu_ps(p, v)
+#define SAT_SET1(v) _mm256_set1_ps(v)
+#define SAT_ZERO() _mm256_setzero_ps()
+#define SAT_ADD(a, b) _mm256_add_ps(a, b)
+#define SAT_SUB(a, b) _mm256_sub_ps(a, b)
+#define SAT_MUL(a, b) _mm256_mul_ps(a, b)
+#define SAT_MIN(a, b) _mm256_min_ps(a, b)
+#define SAT_MAX(a, b) _mm256_max_ps(a, b)
+#define SAT_LT(a, b) _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define SAT_OR(a, b) _mm256_or_ps(a, b)
+#define SAT_SELECT(a, b, mask) _mm256_blendv_ps(a, b, mask)
+#define SAT_MOVEMASK(v) _mm256_movemask_ps(v)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SAT_SIMD_WIDTH 4
+typedef __m128 sat_vf;
+#define SAT_LOAD(p) _mm_loadu_ps(p)
+#define SAT_STORE(p, v) _mm_storeu_ps(p, v)
+#define SAT_SET1(v) _mm_set1_ps(v)
+#define SAT_ZERO() _mm_setzero_ps()
+#define SAT_ADD(a, b) _mm_add_ps(a, b)
+#define SAT_SUB(a, b) _mm_sub_ps(a, b)
+#define SAT_MUL(a, b) _mm_mul_ps(a, b)
+#define SAT_MIN(a, b) _mm_min_ps(a, b)
+#define SAT_MAX(a, b) _mm_max_ps(a, b)
+#define SAT_LT(a, b) _mm_cmplt_ps(a, b)
+#define SAT_OR(a, b) _mm_or_ps(a, b)
+#define SAT_SELECT(a, b, mask) _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a))
+#define SAT_MOVEMASK(v) _mm_movemask_ps(v)
+#endif
+
+/* a onto b */
+Vector2 Vector2Project(Vector2 a, Vector2 b)
+{
+    return Vector2Scale(b, Vector2DotProduct(a, b) / Vector2DotProduct(b, b));
+}
+
+/* Returns perpendicular vector to edge */
+Vector2 Vector2EdgeNormal(Vector2 a, Vector2 b)
+{
+    Vector2 edge = Vector2Subtract(b, a);
+    Vector2 normal = {-edge.y, edge.x};
+    return Vector2Normalize(normal);
+}
+
+// Function to project a set of points onto an axis and find the min and max projections
+void project_onto_vector(const Vector2 *points, int pointCount, Vector2 position, float rotation, Vector2 axis, float *min, float *max)
+{
+    *min = *max = Vector2DotProduct(Vector2Add(Vector2Rotate(points[0], DEG2RAD * rotation), position), axis); // Initialize with the projection of the first point
+    for (int i = 1; i < pointCount; i++)
+    { // Start loop from the second point
+        Vector2 rotatedPoint = Vector2Add(Vector2Rotate(points[i], DEG2RAD * rotation), position);
+        float projection = Vector2DotProduct(rotatedPoint, axis); // Compute the projection
+        if (projection < *min)
+        {
+            *min = projection; // Update min if the current projection is smaller
+        }
+        if (projection > *max)
+        {
+            *max = projection; // Update max if the current projection is larger
+        }
+    }
+}
+
+// Function to check if two projection intervals overlap
+bool is_overlap(float minA, float maxA, float minB, float maxB, float *overlap)
+{
+    if (maxA < minB || maxB < minA)
+    {
+        return false; // No overlap
+    }
+    /* Same for both directions of the axis, so parallel edges can share one axis */
+    *overlap = fminf(maxA, maxB) - fmaxf(minA, minB);
+    return true;
+}
+
+bool point_in_polygon(const Vector2 *polygon, int count, Vector2 position, float rotation, Vector2 point)
+{
+    bool result = false;
+    for (int i = 0, j = count - 1; i < count; j = i++)
+    {
+        Vector2 polygon_i = Vector2Add(Vector2Rotate(polygon[i], DEG2RAD * rotation), position);
+        Vector2 polygon_j = Vector2Add(Vector2Rotate(polygon[j], DEG2RAD * rotation), position);
+        if (((polygon_i.y > point.y) != (polygon_j.y > point.y)) &&
+            (point.x < (polygon_j.x - polygon_i.x) * (point.y - polygon_i.y) / (polygon_j.y - polygon_i.y) + polygon_i.x))
+        {
+            result = !result;
+        }
+    }
+    return result;
+}
+
+/* Outward unit normal of edge i, the winding of the points is not fixed so it is checked against the vertex average */
+static Vector2 shape_outward_normal(const WorldShape *shape, int i, Vector2 inside)
+{
+    Vector2 a = shape->points[i];
+    Vector2 normal = Vector2EdgeNormal(a, shape->points[(i + 1) % shape->num_points]);
+    if (Vector2DotProduct(normal, Vector2Subtract(inside, a)) > 0)
+    {
+        normal = Vector2Negate(normal);
+    }
+    return normal;
+}
+
+static Vector2 shape_vertex_average(const WorldShape *shape)
+{
+    Vector2 sum = {0, 0};
+    int i;
+    for (i = 0; i < shape->num_points; i++)
+    {
+        sum = Vector2Add(sum, shape->points[i]);
+    }
+    return Vector2Scale(sum, 1.0f / shape->num_points);
+}
+
+bool circle_overlaps_shape(const WorldShape *shape, Vector2 center, float radius)
+{
+    if (Vector2DistanceSqr(center, shape->center) > (radius + shape->radius) * (radius + shape->radius))
+    {
+        return false;
+    }
+    Vector2 inside_point = shape_vertex_average(shape);
+    bool inside = true;
+    float closest = FLT_MAX;
+    int i;
+    for (i = 0; i < shape->num_points; i++)
+    {
+        Vector2 a = shape->points[i];
+        Vector2 b = shape->points[(i + 1) % shape->num_points];
+        if (Vector2DotProduct(shape_outward_normal(shape, i, inside_point), Vector2Subtract(center, a)) > 0)
+        {
+            inside = false;
+        }
+        /* Squared distance to the closest point of the edge */
+        Vector2 edge = Vector2Subtract(b, a);
+        float length_sq = Vector2LengthSqr(edge);
+        float t = length_sq > 0 ? Clamp(Vector2DotProduct(Vector2Subtract(center, a), edge) / length_sq, 0, 1) : 0;
+        closest = fminf(closest, Vector2DistanceSqr(center, Vector2Add(a, Vector2Scale(edge, t))));
+    }
+    return inside || closest <= radius * radius;
+}
+
+bool segment_cast_shape(const WorldShape *shape, Vector2 start, Vector2 end, float *t, Vector2 *normal)
+{
+    /* Cyrus-Beck, the segment is clipped by the half plane of every edge */
+    Vector2 inside_point = shape_vertex_average(shape);
+    Vector2 delta = Vector2Subtract(end, start);
+    float enter = 0, exit = 1;
+    Vector2 enter_normal = {0, 0};
+    int i;
+    for (i = 0; i < shape->num_points; i++)
+    {
+        Vector2 edge_normal = shape_outward_normal(shape, i, inside_point);
+        float distance = Vector2DotProduct(edge_normal, Vector2Subtract(start, shape->points[i])); /* > 0 outside */
+        float speed = Vector2DotProduct(edge_normal, delta);
+        if (speed == 0)
+        {
+            if (distance > 0)
+            {
+                return false;
+            }
+            continue;
+        }
+        float crossing = -distance / speed;
+        if (speed < 0)
+        {
+            if (crossing > enter)
+            {
+                enter = crossing;
+                enter_normal = edge_normal;
+            }
+        }
+        else if (crossing < exit)
+        {
+            exit = crossing;
+        }
+        if (enter > exit)
+        {
+            return false;
+        }
+    }
+    *t = enter;
+    *normal = enter_normal;
+    return true;
+}
+
+void world_shape_update(WorldShape *shape, const Vector2 *points, int num_points, Vector2 position, float rotation)
+{
+    int i, j;
+    if (num_points > SHAPE_MAX_POINTS)
+    {
+        fprintf(stderr, "world_shape_update: %d points is more than SHAPE_MAX_POINTS\n", num_points);
+        exit(1);
+    }
+    shape->sin_r = sinf(DEG2RAD * rotation);
+    shape->cos_r = cosf(DEG2RAD * rotation);
+    shape->num_points = num_points;
+    shape->min = (Vector2){FLT_MAX, FLT_MAX};
+    shape->max = (Vector2){-FLT_MAX, -FLT_MAX};
+    shape->center = position;
+    float radius_sq = 0;
+    for (i = 0; i < num_points; i++)
+    {
+        radius_sq = fmaxf(radius_sq, Vector2LengthSqr(points[i]));
+        Vector2 point = {points[i].x * shape->cos_r - points[i].y * shape->sin_r + position.x,
+                         points[i].x * shape->sin_r + points[i].y * shape->cos_r + position.y};
+        shape->points[i] = point;
+        shape->min = Vector2Min(shape->min, point);
+        shape->max = Vector2Max(shape->max, point);
+    }
+    shape->radius = sqrtf(radius_sq);
+    shape->num_axes = 0;
+    for (i = 0; i < num_points; i++)
+    {
+        Vector2 normal = Vector2EdgeNormal(shape->points[i], shape->points[(i + 1) % num_points]);
+        if (Vector2Equals(normal, Vector2Zero()))
+        {
+            continue; /* degenerate edge */
+        }
+        for (j = 0; j < shape->num_axes; j++)
+        {
+            Vector2 axis = shape->axes[j];
+            if (fabsf(normal.x * axis.y - normal.y * axis.x) < SHAPE_PARALLEL_EPSILON)
+            {
+                break; /* opposite edges of a box project onto the same axis */
+            }
+        }
+        if (j == shape->num_axes)
+        {
+            shape->axes[shape->num_axes++] = normal;
+        }
+    }
+}
+
+static void project_world_shape(WorldShape *shape, Vector2 axis, float *min, float *max)
+{
+    *min = *max = Vector2DotProduct(shape->points[0], axis);
+    for (int i = 1; i < shape->num_points; i++)
+    {
+        float projection = Vector2DotProduct(shape->points[i], axis);
+        if (projection < *min)
+        {
+            *min = projection;
+        }
+        if (projection > *max)
+        {
+            *max = projection;
+        }
+    }
+}
+
+/* Tests the axes of owner, returns false as soon as one separates the shapes and leaves it in smallest_axis */
+static bool sat_test_axes(WorldShape *owner, WorldShape *a, WorldShape *b, float *min_overlap, Vector2 *smallest_axis)
+{
+    for (int i = 0; i < owner->num_axes; i++)
+    {
+        Vector2 axis = owner->axes[i];
+        float minA, maxA, minB, maxB, overlap;
+        project_world_shape(a, axis, &minA, &maxA);
+        project_world_shape(b, axis, &minB, &maxB);
+        if (!is_overlap(minA, maxA, minB, maxB, &overlap))
+        {
+            *smallest_axis = axis;
+            return false; // Separation found
+        }
+        if (overlap < *min_overlap)
+        {
+            *min_overlap = overlap;
+            *smallest_axis = axis;
+        }
+    }
+    return true;
+}
+
+bool sat_collision_cached(WorldShape *a, WorldShape *b, Vector2 *mtv)
+{
+    return sat_collision_axis(a, b, mtv, NULL);
+}
+
+bool sat_collision_axis(WorldShape *a, WorldShape *b, Vector2 *mtv, Vector2 *axis)
+{
+    float minOverlap = FLT_MAX;
+    Vector2 smallestAxis = {0, 0};
+
+    if (!sat_test_axes(a, a, b, &minOverlap, &smallestAxis) || !sat_test_axes(b, a, b, &minOverlap, &smallestAxis))
+    {
+        if (axis != NULL)
+        {
+            *axis = smallestAxis;
+        }
+        return false;
+    }
+    if (axis != NULL)
+    {
+        *axis = smallestAxis;
+    }
+
+    // Compute MTV (Minimum Translation Vector), the axes are already unit length
+    if (mtv != NULL)
+    {
+        *mtv = Vector2Scale(smallestAxis, minOverlap);
+    }
+
+    return true; // No separation found, collision detected
+}
+
+bool sat_axis_separates(WorldShape *a, WorldShape *b, Vector2 axis, Vector2 displacement)
+{
+    float minA, maxA, minB, maxB;
+    project_world_shape(a, axis, &minA, &maxA);
+    project_world_shape(b, axis, &minB, &maxB);
+    /* Interval of a swept over the step */
+    float velocity = Vector2DotProduct(displacement, axis);
+    minA += fminf(velocity, 0);
+    maxA += fmaxf(velocity, 0);
+    return maxA < minB || maxB < minA;
+}
+
+bool collision_bounds_overlap(const WorldShape *a, const WorldShape *b, Vector2 displacement, CollisionStats *stats)
+{
+    CollisionStats unused;
+    if (stats == NULL)
+    {
+        stats = &unused;
+    }
+    stats->pairs++;
+    /* Closest approach of the moving center of a to the center of b */
+    Vector2 offset = Vector2Subtract(b->center, a->center);
+    float length_sq = Vector2LengthSqr(displacement);
+    if (length_sq > 0)
+    {
+        float t = Clamp(Vector2DotProduct(offset, displacement) / length_sq, 0.0f, 1.0f);
+        offset = Vector2Subtract(offset, Vector2Scale(displacement, t));
+    }
+    float radius = a->radius + b->radius;
+    if (Vector2LengthSqr(offset) > radius * radius)
+    {
+        stats->circle_rejects++;
+        return false;
+    }
+    Vector2 min = Vector2Min(a->min, Vector2Add(a->min, displacement));
+    Vector2 max = Vector2Max(a->max, Vector2Add(a->max, displacement));
+    if (max.x < b->min.x || b->max.x < min.x || max.y < b->min.y || b->max.y < min.y)
+    {
+        stats->aabb_rejects++;
+        return false;
+    }
+    return true;
+}
+
+bool sat_collision_staged(WorldShape *a, WorldShape *b, Vector2 *mtv, CollisionStats *stats)
+{
+    if (!collision_bounds_overlap(a, b, (Vector2){0, 0}, stats))
+    {
+        return false;
+    }
+    bool hit = sat_collision_cached(a, b, mtv);
+    if (stats != NULL && hit)
+    {
+        stats->hits++;
+    }
+    else if (stats != NULL)
+    {
+        stats->sat_rejects++;
+    }
+    return hit;
+}
+
+bool sat_sweep_staged(WorldShape *a, WorldShape *b, Vector2 displacement, SatSweep *sweep, CollisionStats *stats)
+{
+    if (!collision_bounds_overlap(a, b, displacement, stats))
+    {
+        return false;
+    }
+    bool hit = sat_sweep_cached(a, b, displacement, sweep);
+    if (stats != NULL && hit)
+    {
+        stats->hits++;
+    }
+    else if (stats != NULL)
+    {
+        stats->sat_rejects++;
+    }
+    return hit;
+}
+
+void collision_stats_add(CollisionStats *sum, const CollisionStats *stats)
+{
+    sum->pairs += stats->pairs;
+    sum->circle_rejects += stats->circle_rejects;
+    sum->aabb_rejects += stats->aabb_rejects;
+    sum->sat_rejects += stats->sat_rejects;
+    sum->cached_axis_rejects += stats->cached_axis_rejects;
+    sum->hits += stats->hits;
+}
+
+/* Narrows [*first, *last] to the times the projections on axis overlap, false once it is empty */
+static bool sat_sweep_axis(WorldShape *a, WorldShape *b, Vector2 axis, float velocity, float *first, float *last, Vector2 *normal)
+{
+    float minA, maxA, minB, maxB;
+    project_world_shape(a, axis, &minA, &maxA);
+    project_world_shape(b, axis, &minB, &maxB);
+    if (fabsf(velocity) < SAT_SWEEP_EPSILON)
+    {
+        /* Not moving along this axis, it either separates the shapes for the whole step or never */
+        return !(maxA < minB || maxB < minA);
+    }
+    float enter = (minB - maxA) / velocity;
+    float leave = (maxB - minA) / velocity;
+    if (enter > leave)
+    {
+        float swap = enter;
+        enter = leave;
+        leave = swap;
+    }
+    if (enter > *first)
+    {
+        *first = enter;
+        *normal = velocity > 0 ? Vector2Negate(axis) : axis;
+    }
+    if (leave < *last)
+    {
+        *last = leave;
+    }
+    return *first <= *last;
+}
+
+bool sat_sweep_cached(WorldShape *a, WorldShape *b, Vector2 displacement, SatSweep *sweep)
+{
+    float first = 0, last = 1;
+    Vector2 normal = {0, 0};
+    int i;
+    for (i = 0; i < a->num_axes; i++)
+    {
+        if (!sat_sweep_axis(a, b, a->axes[i], Vector2DotProduct(displacement, a->axes[i]), &first, &last, &normal))
+        {
+            return false;
+        }
+    }
+    for (i = 0; i < b->num_axes; i++)
+    {
+        if (!sat_sweep_axis(a, b, b->axes[i], Vector2DotProduct(displacement, b->axes[i]), &first, &last, &normal))
+        {
+            return false;
+        }
+    }
+    if (sweep != NULL)
+    {
+        sweep->toi = first;
+        sweep->exit = last;
+        sweep->normal = normal;
+    }
+    return true;
+}
+
+bool sat_collision(Vector2 *shapeA, int countA, Vector2 positionA, float rotationA, Vector2 *shapeB, int countB, Vector2 positionB, float rotationB, Vector2 *mtv)
+{
+    WorldShape a, b;
+    world_shape_update(&a, shapeA, countA, positionA, rotationA);
+    world_shape_update(&b, shapeB, countB, positionB, rotationB);
+    return sat_collision_cached(&a, &b, mtv);
+}
+
+void sat_batch_clear(SatBatch *batch)
+{
+    batch->count = 0;
+    batch->max_points = 0;
+    batch->max_axes = 0;
+}
+
+int sat_batch_add(SatBatch *batch, WorldShape *shape)
+{
+    if (batch->count >= SAT_BATCH_LANES)
+    {
+        return -1;
+    }
+    int lane = batch->count++, i;
+    for (i = 0; i < shape->num_points; i++)
+    {
+        batch->x[i][lane] = shape->points[i].x;
+        batch->y[i][lane] = shape->points[i].y;
+    }
+    for (i = 0; i < shape->num_axes; i++)
+    {
+        batch->axis_x[i][lane] = shape->axes[i].x;
+        batch->axis_y[i][lane] = shape->axes[i].y;
+    }
+    batch->shapes[lane] = shape;
+    if (shape->num_points > batch->max_points)
+        batch->max_points = shape->num_points;
+    if (shape->num_axes > batch->max_axes)
+        batch->max_axes = shape->num_axes;
+    return lane;
+}
+
+unsigned int sat_collision_batch_scalar(WorldShape *shape, SatBatch *batch, Vector2 *mtvs)
+{
+    unsigned int hits = 0;
+    int lane;
+    for (lane = 0; lane < batch->count; lane++)
+    {
+        if (sat_collision_cached(shape, batch->shapes[lane], mtvs ? &mtvs[lane] : NULL))
+        {
+            hits |= 1u << lane;
+        }
+    }
+    return hits;
+}
+
+#ifdef SAT_SIMD_WIDTH
+/*
+    Repeats the last vertex and the first axis of short lanes and copies lane 0 into unused lanes.
+    A repeated vertex does not change a projection interval and a repeated axis gives the same overlap
+    again, which never replaces the smallest overlap because the compare is strict.
+*/
+static void sat_batch_pad(SatBatch *batch)
+{
+    int lane, i;
+    for (lane = 0; lane < SAT_BATCH_LANES; lane++)
+    {
+        int num_points = lane < batch->count ? batch->shapes[lane]->num_points : 0;
+        int num_axes = lane < batch->count ? batch->shapes[lane]->num_axes : 0;
+        for (i = num_points; i < batch->max_points; i++)
+        {
+            batch->x[i][lane] = num_points ? batch->x[num_points - 1][lane] : batch->x[i][0];
+            batch->y[i][lane] = num_points ? batch->y[num_points - 1][lane] : batch->y[i][0];
+        }
+        for (i = num_axes; i < batch->max_axes; i++)
+        {
+            batch->axis_x[i][lane] = num_axes ? batch->axis_x[0][lane] : batch->axis_x[i][0];
+            batch->axis_y[i][lane] = num_axes ? batch->axis_y[0][lane] : batch->axis_y[i][0];
+        }
+    }
+}
+
+/* Keeps the overlap and axis of lanes where this axis overlaps less, marks lanes this axis separates */
+static void sat_simd_axis(sat_vf min_a, sat_vf max_a, sat_vf min_b, sat_vf max_b, sat_vf axis_x, sat_vf axis_y,
+                          sat_vf *separated, sat_vf *min_overlap, sat_vf *smallest_x, sat_vf *smallest_y)
+{
+    *separated = SAT_OR(*separated, SAT_OR(SAT_LT(max_a, min_b), SAT_LT(max_b, min_a)));
+    sat_vf overlap = SAT_SUB(SAT_MIN(max_a, max_b), SAT_MAX(min_a, min_b));
+    sat_vf smaller = SAT_LT(overlap, *min_overlap);
+    *min_overlap = SAT_SELECT(*min_overlap, overlap, smaller);
+    *smallest_x = SAT_SELECT(*smallest_x, axis_x, smaller);
+    *smallest_y = SAT_SELECT(*smallest_y, axis_y, smaller);
+}
+
+unsigned int sat_collision_batch(WorldShape *shape, SatBatch *batch, Vector2 *mtvs)
+{
+    if (!batch->count)
+    {
+        return 0;
+    }
+    sat_batch_pad(batch);
+    float shape_min[SHAPE_MAX_POINTS], shape_max[SHAPE_MAX_POINTS];
+    int i, k, v, offset;
+    for (k = 0; k < shape->num_axes; k++)
+    {
+        project_world_shape(shape, shape->axes[k], &shape_min[k], &shape_max[k]);
+    }
+
+    unsigned int hits = 0;
+    for (offset = 0; offset < batch->count; offset += SAT_SIMD_WIDTH)
+    {
+        sat_vf separated = SAT_ZERO(), min_overlap = SAT_SET1(FLT_MAX), smallest_x = SAT_ZERO(), smallest_y = SAT_ZERO();
+
+        // Normals of the single shape, its projection is the same for every lane
+        for (k = 0; k < shape->num_axes; k++)
+        {
+            sat_vf axis_x = SAT_SET1(shape->axes[k].x), axis_y = SAT_SET1(shape->axes[k].y);
+            sat_vf min_b = SAT_ADD(SAT_MUL(SAT_LOAD(&batch->x[0][offset]), axis_x), SAT_MUL(SAT_LOAD(&batch->y[0][offset]), axis_y));
+            sat_vf max_b = min_b;
+            for (v = 1; v < batch->max_points; v++)
+            {
+                sat_vf projection = SAT_ADD(SAT_MUL(SAT_LOAD(&batch->x[v][offset]), axis_x), SAT_MUL(SAT_LOAD(&batch->y[v][offset]), axis_y));
+                min_b = SAT_MIN(min_b, projection);
+                max_b = SAT_MAX(max_b, projection);
+            }
+            sat_simd_axis(SAT_SET1(shape_min[k]), SAT_SET1(shape_max[k]), min_b, max_b, axis_x, axis_y, &separated, &min_overlap, &smallest_x, &smallest_y);
+        }
+
+        // Normals of the batched shapes, one axis per lane
+        for (k = 0; k < batch->max_axes; k++)
+        {
+            sat_vf axis_x = SAT_LOAD(&batch->axis_x[k][offset]), axis_y = SAT_LOAD(&batch->axis_y[k][offset]);
+            sat_vf min_a = SAT_ADD(SAT_MUL(SAT_SET1(shape->points[0].x), axis_x), SAT_MUL(SAT_SET1(shape->points[0].y), axis_y));
+            sat_vf max_a = min_a;
+            for (v = 1; v < shape->num_points; v++)
+            {
+                sat_vf projection = SAT_ADD(SAT_MUL(SAT_SET1(shape->points[v].x), axis_x), SAT_MUL(SAT_SET1(shape->points[v].y), axis_y));
+                min_a = SAT_MIN(min_a, projection);
+                max_a = SAT_MAX(max_a, projection);
+            }
+            sat_vf min_b = SAT_ADD(SAT_MUL(SAT_LOAD(&batch->x[0][offset]), axis_x), SAT_MUL(SAT_LOAD(&batch->y[0][offset]), axis_y));
+            sat_vf max_b = min_b;
+            for (v = 1; v < batch->max_points; v++)
+            {
+                sat_vf projection = SAT_ADD(SAT_MUL(SAT_LOAD(&batch->x[v][offset]), axis_x), SAT_MUL(SAT_LOAD(&batch->y[v][offset]), axis_y));
+                min_b = SAT_MIN(min_b, projection);
+                max_b = SAT_MAX(max_b, projection);
+            }
+            sat_simd_axis(min_a, max_a, min_b, max_b, axis_x, axis_y, &separated, &min_overlap, &smallest_x, &smallest_y);
+        }
+
+        unsigned int lane_hits = ~(unsigned int)SAT_MOVEMASK(separated) & ((1u << SAT_SIMD_WIDTH) - 1);
+        if (offset + SAT_SIMD_WIDTH > batch->count)
+        {
+            lane_hits &= (1u << (batch->count - offset)) - 1;
+        }
+        if (mtvs != NULL && lane_hits)
+        {
+            float overlap[SAT_SIMD_WIDTH], axis_x[SAT_SIMD_WIDTH], axis_y[SAT_SIMD_WIDTH];
+            SAT_STORE(overlap, min_overlap);
+            SAT_STORE(axis_x, smallest_x);
+            SAT_STORE(axis_y, smallest_y);
+            for (i = 0; i < SAT_SIMD_WIDTH; i++)
+            {
+                if (lane_hits & (1u << i))
+                {
+                    mtvs[offset + i] = Vector2Scale((Vector2){axis_x[i], axis_y[i]}, overlap[i]);
+                }
+            }
+        }
+        hits |= lane_hits << offset;
+    }
+    return hits;
+}
+#else
+unsigned int sat_collision_batch(WorldShape *shape, SatBatch *batch, Vector2 *mtvs)
+{
+    return sat_collision_batch_scalar(shape, batch, mtvs);
+}
+#endif
@@ -0,0 +1,270 @@
+/**
+ * @file collision.h
+ * @brief Separating axis test and polygon helpers.
+ *
+ */
+
+#ifndef COLLISION_H_
+#define COLLISION_H_
+
+#include <stdbool.h>
+#include <raylib.h>
+
+/*
+    INFO:
+        Shapes are convex polygons in local space, rotated in degrees around their center.
+        WorldShape caches the world space vertices and unique edge normals of one shape,
+        it is filled once per tick with world_shape_update and then read by every SAT test the shape is part of.
+        The narrow phase is a cascade, a pair is first tested with the bounding circles, then with the
+        world space AABBs and only then with SAT. Every stage counts the pairs it rejects in a CollisionStats.
+*/
+
+#define SHAPE_MAX_POINTS 16
+/* Normals whose cross product is below this are treated as the same axis */
+#define SHAPE_PARALLEL_EPSILON 0.0001f
+/* Relative speeds along an axis below this are treated as not moving in sat_sweep_cached */
+#define SAT_SWEEP_EPSILON 0.00001f
+
+typedef struct
+{
+    Vector2 points[SHAPE_MAX_POINTS]; /* world space vertices */
+    Vector2 axes[SHAPE_MAX_POINTS];   /* unit edge normals, parallel edges share one axis */
+    int num_points;
+    int num_axes;
+    float sin_r;
+    float cos_r;
+    Vector2 min; /* world space AABB of the vertices */
+    Vector2 max;
+    Vector2 center; /* bounding circle around the rotation center, holds at any rotation */
+    float radius;
+} WorldShape;
+
+/* Pairs that entered the narrow phase cascade and where each stage rejected them */
+typedef struct
+{
+    unsigned int pairs;
+    unsigned int circle_rejects; /* bounding circles do not touch */
+    unsigned int aabb_rejects;   /* world space AABBs do not overlap */
+    unsigned int sat_rejects;    /* separated on an axis */
+    unsigned int cached_axis_rejects; /* part of sat_rejects, separated by the axis cached from the previous tick alone */
+    unsigned int hits;
+} CollisionStats;
+
+/* Result of sat_sweep_cached, times are fractions of the step */
+typedef struct
+{
+    float toi;      /* first time the shapes touch, 0 if they overlap at the start */
+    float exit;     /* last time they touch, 1 if they still touch at the end */
+    Vector2 normal; /* unit axis they touch on at toi pointing from b towards a, zero if toi is 0 */
+} SatSweep;
+
+/* Number of shapes tested by one call to sat_collision_batch */
+#define SAT_BATCH_LANES 8
+
+/*
+    Block of up to SAT_BATCH_LANES shapes stored as structure of arrays,
+    vertex v of lane l is (x[v][l], y[v][l]). Lanes with fewer vertices or axes than the
+    largest lane are padded by sat_collision_batch with copies that do not change the result.
+*/
+typedef struct
+{
+    float x[SHAPE_MAX_POINTS][SAT_BATCH_LANES];
+    float y[SHAPE_MAX_POINTS][SAT_BATCH_LANES];
+    float axis_x[SHAPE_MAX_POINTS][SAT_BATCH_LANES];
+    float axis_y[SHAPE_MAX_POINTS][SAT_BATCH_LANES];
+    WorldShape *shapes[SAT_BATCH_LANES];
+    int count;
+    int max_points;
+    int max_axes;
+} SatBatch;
+
+/* a onto b */
+Vector2 Vector2Project(Vector2 a, Vector2 b);
+
+/* Returns perpendicular vector to edge */
+Vector2 Vector2EdgeNormal(Vector2 a, Vector2 b);
+
+/**
+ * @brief Projects local space points onto an axis after rotating and translating them.
+ *
+ * @param points Local space points.
+ * @param pointCount Number of points.
+ * @param position World position of the shape center.
+ * @param rotation Rotation in degrees.
+ * @param axis Axis to project onto.
+ * @param min Smallest projection.
+ * @param max Largest projection.
+ */
+void project_onto_vector(const Vector2 *points, int pointCount, Vector2 position, float rotation, Vector2 axis, float *min, float *max);
+
+/**
+ * @brief Checks if two projection intervals overlap.
+ *
+ * @return true if they overlap, overlap is set to the length of the overlap.
+ */
+bool is_overlap(float minA, float maxA, float minB, float maxB, float *overlap);
+
+/**
+ * @brief Even-odd test of a point against a rotated and translated polygon.
+ */
+bool point_in_polygon(const Vector2 *polygon, int count, Vector2 position, float rotation, Vector2 point);
+
+/**
+ * @brief Tests a circle against a convex world space shape.
+ *
+ * @return true if the circle touches or overlaps the shape, also when it lies completely inside it.
+ */
+bool circle_overlaps_shape(const WorldShape *shape, Vector2 center, float radius);
+
+/**
+ * @brief Clips a segment against a convex world space shape.
+ *
+ * @param shape Convex shape to clip against.
+ * @param start First point of the segment.
+ * @param end Last point of the segment.
+ * @param t Set to the fraction of the segment at which it enters the shape, 0 if start is inside.
+ * @param normal Set to the outward unit normal of the edge it enters through, zero if start is inside.
+ * @return true if the segment touches the shape.
+ */
+bool segment_cast_shape(const WorldShape *shape, Vector2 start, Vector2 end, float *t, Vector2 *normal);
+
+/**
+ * @brief Transforms a local space shape into world space and computes its unique edge normals.
+ *
+ * @param shape Cache to fill.
+ * @param points Local space points, at most SHAPE_MAX_POINTS.
+ * @param num_points Number of points.
+ * @param position World position of the shape center.
+ * @param rotation Rotation in degrees.
+ *
+ * @details sin and cos of the rotation are computed once here instead of once per point per axis.
+ */
+void world_shape_update(WorldShape *shape, const Vector2 *points, int num_points, Vector2 position, float rotation);
+
+/**
+ * @brief Separating axis test between two cached shapes.
+ *
+ * @param a First shape.
+ * @param b Second shape.
+ * @param mtv Minimum translation vector, can be NULL. Its sign is not oriented from one shape to the other.
+ * @return true if the shapes overlap.
+ */
+bool sat_collision_cached(WorldShape *a, WorldShape *b, Vector2 *mtv);
+
+/**
+ * @brief Cheap stages of the narrow phase, tests the bounding circles and then the AABBs.
+ *
+ * @param a First shape at the start of the step.
+ * @param b Second shape at the start of the step.
+ * @param displacement Movement of a relative to b over the step, zero for a test at the start only.
+ * @param stats Counts the pair and the rejecting stage. Can be NULL.
+ * @return false if the shapes cannot touch, true if SAT has to decide.
+ */
+bool collision_bounds_overlap(const WorldShape *a, const WorldShape *b, Vector2 displacement, CollisionStats *stats);
+
+/**
+ * @brief Full cascade for shapes at rest, collision_bounds_overlap then sat_collision_cached.
+ *
+ * @param a First shape.
+ * @param b Second shape.
+ * @param mtv Minimum translation vector, can be NULL.
+ * @param stats Counts the pair and the rejecting stage. Can be NULL.
+ * @return true if the shapes overlap.
+ */
+bool sat_collision_staged(WorldShape *a, WorldShape *b, Vector2 *mtv, CollisionStats *stats);
+
+/**
+ * @brief Full cascade for moving shapes, collision_bounds_overlap then sat_sweep_cached.
+ *
+ * @param a First shape at the start of the step.
+ * @param b Second shape at the start of the step.
+ * @param displacement Movement of a relative to b over the whole step.
+ * @param sweep Time of impact and contact normal, only written on a hit. Can be NULL.
+ * @param stats Counts the pair and the rejecting stage. Can be NULL.
+ * @return true if the shapes touch at any time of the step.
+ */
+bool sat_sweep_staged(WorldShape *a, WorldShape *b, Vector2 displacement, SatSweep *sweep, CollisionStats *stats);
+
+/* Adds every counter of stats to sum */
+void collision_stats_add(CollisionStats *sum, const CollisionStats *stats);
+
+/**
+ * @brief Swept separating axis test between two cached shapes that move without rotating.
+ *
+ * @param a First shape at the start of the step.
+ * @param b Second shape at the start of the step.
+ * @param displacement Movement of a relative to b over the whole step.
+ * @param sweep Time of impact and contact normal, only written on a hit. Can be NULL.
+ * @return true if the shapes touch at any time of the step.
+ *
+ * @details For every axis of both shapes the time interval in which the projections overlap is computed,
+ * the shapes touch where all intervals overlap. The rotation during the step is ignored, fast bodies
+ * are caught even if they pass completely through each other between the start and the end.
+ */
+bool sat_sweep_cached(WorldShape *a, WorldShape *b, Vector2 displacement, SatSweep *sweep);
+
+/**
+ * @brief sat_collision_cached that also reports the axis that decided the test.
+ *
+ * @param a First shape.
+ * @param b Second shape.
+ * @param mtv Minimum translation vector, can be NULL.
+ * @param axis Set to the separating axis on a miss and to the MTV axis on a hit. Can be NULL.
+ * @return true if the shapes overlap.
+ */
+bool sat_collision_axis(WorldShape *a, WorldShape *b, Vector2 *mtv, Vector2 *axis);
+
+/**
+ * @brief Tests a single axis, any axis that separates the projections proves the shapes do not touch.
+ *
+ * @param a First shape at the start of the step.
+ * @param b Second shape at the start of the step.
+ * @param axis Unit axis to project onto, for example one cached from the previous tick.
+ * @param displacement Movement of a relative to b over the step, zero for a test at the start only.
+ * @return true if the axis separates the shapes during the whole step.
+ */
+bool sat_axis_separates(WorldShape *a, WorldShape *b, Vector2 axis, Vector2 displacement);
+
+/**
+ * @brief Separating axis test between two local space shapes.
+ *
+ * @details Builds a WorldShape for both shapes and calls sat_collision_cached.
+ * Use the cached version when a shape takes part in more than one test per tick.
+ */
+bool sat_collision(Vector2 *shapeA, int countA, Vector2 positionA, float rotationA, Vector2 *shapeB, int countB, Vector2 positionB, float rotationB, Vector2 *mtv);
+
+/**
+ * @brief Empties a batch.
+ *
+ * @param batch Batch to clear.
+ */
+void sat_batch_clear(SatBatch *batch);
+
+/**
+ * @brief Copies a cached shape into the next free lane of the batch.
+ *
+ * @param batch Batch to add to.
+ * @param shape Cached shape, must stay valid until the batch is tested.
+ * @return int Lane of the shape, -1 if the batch is full.
+ */
+int sat_batch_add(SatBatch *batch, WorldShape *shape);
+
+/**
+ * @brief Separating axis test of one shape against every shape in a batch.
+ *
+ * @param shape Shape tested against every lane, it takes the place of a in sat_collision_cached.
+ * @param batch Shapes to test against.
+ * @param mtvs Array of SAT_BATCH_LANES MTVs, only lanes that hit are written. Can be NULL.
+ * @return unsigned int Bit l is set if shape overlaps the shape in lane l.
+ *
+ * @details Uses AVX2 or SSE2 lanes when the compiler targets them, sat_collision_batch_scalar otherwise.
+ * Results are the same as calling sat_collision_cached(shape, lane) for every lane.
+ */
+unsigned int sat_collision_batch(WorldShape *shape, SatBatch *batch, Vector2 *mtvs);
+
+/**
+ * @brief Scalar fallback of sat_collision_batch, calls sat_collision_cached for every lane.
+ */
+unsigned int sat_collision_batch_scalar(WorldShape *shape, SatBatch *batch, Vector2 *mtvs);
+
+#endif
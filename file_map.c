@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "file_map.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct FileMap
+{
+    const void *data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+static void *file_map_calloc(size_t count, size_t size)
+{
+    void *ptr = calloc(count, size);
+    if (!ptr)
+    {
+        fprintf(stderr, "Failed to allocate memory for file map\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+#ifdef _WIN32
+FileMap *file_map_open(const char *path)
+{
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return NULL;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+    const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return NULL;
+    }
+    FileMap *map = (FileMap *)file_map_calloc(1, sizeof(FileMap));
+    map->data = data;
+    map->size = (size_t)size.QuadPart;
+    map->file = file;
+    map->mapping = mapping;
+    return map;
+}
+
+void file_map_close(FileMap *map)
+{
+    if (!map)
+        return;
+    UnmapViewOfFile(map->data);
+    CloseHandle(map->mapping);
+    CloseHandle(map->file);
+    free(map);
+}
+#else
+FileMap *file_map_open(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        return NULL;
+    }
+    void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    /* The mapping keeps the file alive */
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return NULL;
+    }
+    FileMap *map = (FileMap *)file_map_calloc(1, sizeof(FileMap));
+    map->data = data;
+    map->size = (size_t)info.st_size;
+    return map;
+}
+
+void file_map_close(FileMap *map)
+{
+    if (!map)
+        return;
+    munmap((void *)map->data, map->size);
+    free(map);
+}
+#endif
+
+const void *file_map_data(const FileMap *map)
+{
+    return map->data;
+}
+
+size_t file_map_size(const FileMap *map)
+{
+    return map->size;
+}
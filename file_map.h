@@ -0,0 +1,54 @@
+/**
+ * @file file_map.h
+ * @brief Read-only memory mapping of a whole file.
+ *
+ */
+
+#ifndef FILE_MAP_H_
+#define FILE_MAP_H_
+
+#include <stddef.h>
+
+/*
+    INFO:
+        The file is mapped with mmap or MapViewOfFile, nothing is read until a page is touched.
+        The mapping starts on a page boundary, so data at an offset aligned to a power of two up to
+        the page size is just as aligned in memory.
+        FileMap is opaque because it holds the platform handles, file_map.c includes windows.h
+        and must not include raylib.h.
+*/
+
+typedef struct FileMap FileMap;
+
+/**
+ * @brief Maps a file read-only.
+ *
+ * @param path File to map.
+ * @return FileMap* NULL if the file cannot be opened, is empty or cannot be mapped.
+ */
+FileMap *file_map_open(const char *path);
+
+/**
+ * @brief Unmaps the file and frees the map, pointers returned by file_map_data become invalid.
+ *
+ * @param map Map to close.
+ */
+void file_map_close(FileMap *map);
+
+/**
+ * @brief Returns the first byte of the mapped file.
+ *
+ * @param map Open map.
+ * @return const void*
+ */
+const void *file_map_data(const FileMap *map);
+
+/**
+ * @brief Returns the size of the mapped file in bytes.
+ *
+ * @param map Open map.
+ * @return size_t
+ */
+size_t file_map_size(const FileMap *map);
+
+#endif
@@ -0,0 +1,236 @@
+/**
+ * @file headless.c
+ * @brief Runs the simulation without a window, for build machines and for profiling the physics
+ * apart from the renderer.
+ *
+ * Usage: Headless [--record log | --replay log | --load snapshot] [--save snapshot] [ticks] [seed] [threads] [asteroids] [trace]
+ * threads 0 uses one per hardware thread, asteroids adds that many big asteroids to the starting scene.
+ * trace writes the profiler zones of the last ticks as Chrome trace JSON, every tick is one frame.
+ * --record writes the scripted run to a replay log. --replay runs every tick of a log as fast as possible
+ * instead of the script, ticks, seed and asteroids come from the log, and fails unless the result matches it.
+ * --load starts the script from a snapshot instead of seed and asteroids, --save writes the world after the last tick.
+ * --tunnel fires at a lone small asteroid at several tick rates and fails unless every shot hits, then exits.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "world.h"
+#include "profiler.h"
+#include "replay.h"
+#include "snapshot.h"
+
+#define HEADLESS_DEFAULT_TICKS 3600
+#define HEADLESS_DEFAULT_SEED 1
+#define HEADLESS_DEFAULT_THREADS 1
+#define HEADLESS_DT (1.0f / 60.0f)
+#define HEADLESS_WIDTH 800
+#define HEADLESS_HEIGHT 450
+
+/* Wall clock seconds, clock() would add up the time of every worker thread */
+static double headless_now(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Fixed input script so every run with the same seed simulates the same game */
+static WorldInputs headless_inputs(int tick)
+{
+    WorldInputs inputs = {0};
+    inputs.thrust = tick % 50 < 20;
+    inputs.rotate_left = tick % 70 < 10;
+    inputs.shoot = tick % 5 == 0;
+    inputs.drag = tick % 100 < 5;
+    inputs.drag_position = (Vector2){HEADLESS_WIDTH / 2, HEADLESS_HEIGHT / 2};
+    return inputs;
+}
+
+/* Shots per tick rate and distance range of the tunneling check */
+#define HEADLESS_TUNNEL_SHOTS 20
+
+/* Fires once at a lone small asteroid distance px ahead of the ship, true if the shot destroys it */
+static bool headless_tunnel_hit(float rate, float distance)
+{
+    World *world = world_new_empty((Vector2){1000, 1000}, HEADLESS_DEFAULT_SEED, 1, 16);
+    world->ship.entity.position = (Vector2){500, 100};
+    world->ship.state.last_time_shot = -1; /* the cooldown does not delay the shot at any tick rate */
+    asteroid_spawn(world, ASTEROID_RADIUS_SMALL, (Vector2){500, 100 + distance}, (Vector2){0, 0});
+    WorldInputs inputs = {0};
+    float dt = 1.0f / rate;
+    bool hit = false;
+    int tick;
+    for (tick = 0; !hit && tick * dt < 3.0f; tick++)
+    {
+        inputs.shoot = tick == 1;
+        world_begin_frame(world);
+        world_step(world, dt, &inputs);
+        hit = world->asteroids->count != 1;
+    }
+    world_free(world);
+    return hit;
+}
+
+/*
+    Close targets are crossed during the tick the projectile is fired in at low rates, so they catch
+    leaves that are not swept from their first tick on. Far targets are crossed in later ticks.
+*/
+static int headless_tunnel_check(void)
+{
+    static const float rates[] = {60, 10, 5, 2};
+    int result = 0;
+    size_t r;
+    for (r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+    {
+        int close = 0, far = 0, k;
+        for (k = 0; k < HEADLESS_TUNNEL_SHOTS; k++)
+        {
+            close += headless_tunnel_hit(rates[r], 30.0f + k * 3.0f);
+            far += headless_tunnel_hit(rates[r], 200.0f + k * 10.0f);
+        }
+        printf("%2.0f Hz  close (30-87 px) %d/%d  far (200-390 px) %d/%d\n", rates[r], close, HEADLESS_TUNNEL_SHOTS, far, HEADLESS_TUNNEL_SHOTS);
+        if (close != HEADLESS_TUNNEL_SHOTS || far != HEADLESS_TUNNEL_SHOTS)
+        {
+            result = 1;
+        }
+    }
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    const char *record_path = NULL;
+    const char *replay_path = NULL;
+    const char *load_path = NULL;
+    const char *save_path = NULL;
+    char *args[5] = {NULL};
+    int arg_count = 0;
+    int i;
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+        {
+            record_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+        {
+            replay_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc)
+        {
+            load_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--tunnel") == 0)
+        {
+            return headless_tunnel_check();
+        }
+        else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc)
+        {
+            save_path = argv[++i];
+        }
+        else if (arg_count < 5)
+        {
+            args[arg_count++] = argv[i];
+        }
+    }
+    int ticks = args[0] ? atoi(args[0]) : HEADLESS_DEFAULT_TICKS;
+    ReplayHeader header;
+    header.seed = args[1] ? (unsigned int)strtoul(args[1], NULL, 10) : HEADLESS_DEFAULT_SEED;
+    int threads = args[2] ? atoi(args[2]) : HEADLESS_DEFAULT_THREADS;
+    header.asteroids = args[3] ? (unsigned int)atoi(args[3]) : 0;
+    const char *trace_path = args[4];
+    header.size = (Vector2){HEADLESS_WIDTH, HEADLESS_HEIGHT};
+    header.dt = HEADLESS_DT;
+    Replay *replay = NULL;
+    if (replay_path || load_path)
+    {
+        record_path = NULL; /* a replay of a replay would be the same log, a loaded world has no seed to record */
+    }
+    if (replay_path)
+    {
+        replay = replay_play_open(replay_path);
+    }
+    else if (record_path)
+    {
+        replay = replay_record_open(record_path, &header);
+    }
+    if ((replay_path || record_path) && !replay)
+    {
+        return 1;
+    }
+    World *world;
+    if (replay_path)
+    {
+        header = replay->header;
+        world = replay_world_new(replay, threads);
+    }
+    else if (load_path)
+    {
+        Snapshot *snapshot = snapshot_open(load_path);
+        if (!snapshot)
+        {
+            return 1;
+        }
+        double load_start = headless_now();
+        world = snapshot_load(snapshot, threads);
+        printf("loaded %d asteroids in %.3f ms\n", world->asteroids->count, (headless_now() - load_start) * 1000.0);
+        snapshot_close(snapshot);
+    }
+    else
+    {
+        world = world_new(header.size, header.seed, threads);
+        world_add_asteroids(world, (int)header.asteroids);
+    }
+    int tick;
+    double start = headless_now();
+    for (tick = 0; replay_path || tick < ticks; tick++)
+    {
+        profiler_frame();
+        world_begin_frame(world);
+        WorldInputs inputs;
+        float dt = HEADLESS_DT;
+        if (replay_path)
+        {
+            if (!replay_play_tick(replay, &dt, &world->size, &inputs))
+            {
+                break;
+            }
+        }
+        else
+        {
+            inputs = headless_inputs(tick);
+        }
+        if (record_path)
+        {
+            replay_record_tick(replay, dt, world->size, &inputs);
+        }
+        world_step(world, dt, &inputs);
+    }
+    ticks = tick;
+    double seconds = headless_now() - start;
+    printf("threads %d\n", job_pool_worker_count(world->job_pool));
+    printf("ticks %d seed %u asteroids %d projectiles %d health %d checksum %08x\n", ticks, header.seed, world->asteroids->count, (int)vec_size(world->projectile_vec), world->ship.entity.health, world_checksum(world));
+    printf("total %.3f ms, %.3f us/tick\n", seconds * 1000.0, ticks > 0 ? seconds * 1000000.0 / ticks : 0.0);
+    int result = 0;
+    if (replay && !replay_close(replay, world))
+    {
+        fprintf(stderr, replay_path ? "Replay %s does not match the recorded game\n" : "Failed to write the replay %s\n", replay_path ? replay_path : record_path);
+        result = 1;
+    }
+    else if (replay_path)
+    {
+        printf("replay matches\n");
+    }
+    if (save_path && !snapshot_save(world, save_path))
+    {
+        result = 1;
+    }
+    if (trace_path && !profiler_write_chrome_trace(trace_path))
+    {
+        result = 1;
+    }
+    world_free(world);
+    return result;
+}
@@ -0,0 +1,136 @@
+#include <raylib.h>
+#include <math.h>
+#include "integrate.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define INTEGRATE_SIMD_WIDTH 8
+typedef __m256 integrate_vf;
+#define INTEGRATE_LOAD(p) _mm256_loadu_ps(p)
+#define INTEGRATE_STORE(p, v) _mm256_storeu_ps(p, v)
+#define INTEGRATE_SET1(v) _mm256_set1_ps(v)
+#define INTEGRATE_SET_XY(x, y) _mm256_setr_ps(x, y, x, y, x, y, x, y)
+#define INTEGRATE_ZERO() _mm256_setzero_ps()
+#define INTEGRATE_ADD(a, b) _mm256_add_ps(a, b)
+#define INTEGRATE_SUB(a, b) _mm256_sub_ps(a, b)
+#define INTEGRATE_MUL(a, b) _mm256_mul_ps(a, b)
+#define INTEGRATE_MIN(a, b) _mm256_min_ps(a, b)
+#define INTEGRATE_MAX(a, b) _mm256_max_ps(a, b)
+#define INTEGRATE_GT(a, b) _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+#define INTEGRATE_LT(a, b) _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define INTEGRATE_OR(a, b) _mm256_or_ps(a, b)
+#define INTEGRATE_SELECT(a, b, mask) _mm256_blendv_ps(a, b, mask)
+#define INTEGRATE_MOVEMASK(v) _mm256_movemask_ps(v)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define INTEGRATE_SIMD_WIDTH 4
+typedef __m128 integrate_vf;
+#define INTEGRATE_LOAD(p) _mm_loadu_ps(p)
+#define INTEGRATE_STORE(p, v) _mm_storeu_ps(p, v)
+#define INTEGRATE_SET1(v) _mm_set1_ps(v)
+#define INTEGRATE_SET_XY(x, y) _mm_setr_ps(x, y, x, y)
+#define INTEGRATE_ZERO() _mm_setzero_ps()
+#define INTEGRATE_ADD(a, b) _mm_add_ps(a, b)
+#define INTEGRATE_SUB(a, b) _mm_sub_ps(a, b)
+#define INTEGRATE_MUL(a, b) _mm_mul_ps(a, b)
+#define INTEGRATE_MIN(a, b) _mm_min_ps(a, b)
+#define INTEGRATE_MAX(a, b) _mm_max_ps(a, b)
+#define INTEGRATE_GT(a, b) _mm_cmpgt_ps(a, b)
+#define INTEGRATE_LT(a, b) _mm_cmplt_ps(a, b)
+#define INTEGRATE_OR(a, b) _mm_or_ps(a, b)
+#define INTEGRATE_SELECT(a, b, mask) _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a))
+#define INTEGRATE_MOVEMASK(v) _mm_movemask_ps(v)
+#endif
+
+/* Moves, wraps and clamps one coordinate, returns whether it wrapped. The SIMD lanes compute the same. */
+static int integrate_coordinate(float *position, float *velocity, float position_dt, float bound, float max_velocity)
+{
+    float moved = *position + *velocity * position_dt;
+    int above = moved > bound, below = moved < 0;
+    *position = above ? 0 : (below ? bound : moved);
+    /* max first, so a NaN velocity ends up at -max_velocity like it does in the lanes */
+    *velocity = fminf(max_velocity, fmaxf(-max_velocity, *velocity));
+    return above | below;
+}
+
+/* Moves entities [first, count), pushes the ones that wrapped */
+static void integrate_wrap_entities(Vector2 *position, Vector2 *velocity, int first, int count, float position_dt, Vector2 size, Vector2 max_velocity, Vec *wrapped)
+{
+    int i;
+    for (i = first; i < count; i++)
+    {
+        int wrapped_x = integrate_coordinate(&position[i].x, &velocity[i].x, position_dt, size.x, max_velocity.x);
+        int wrapped_y = integrate_coordinate(&position[i].y, &velocity[i].y, position_dt, size.y, max_velocity.y);
+        if (wrapped_x | wrapped_y)
+        {
+            vec_push_back(wrapped, &i);
+        }
+    }
+}
+
+static void integrate_rotation(float *rotation, const float *angular_velocity, int first, int count, float rotation_dt)
+{
+    int i;
+    for (i = first; i < count; i++)
+    {
+        rotation[i] += angular_velocity[i] * rotation_dt;
+    }
+}
+
+void integrate_wrap_scalar(Vector2 *position, Vector2 *velocity, float *rotation, const float *angular_velocity, int count,
+                           float position_dt, float rotation_dt, Vector2 size, Vector2 max_velocity, Vec *wrapped)
+{
+    vec_clear(wrapped);
+    integrate_wrap_entities(position, velocity, 0, count, position_dt, size, max_velocity, wrapped);
+    integrate_rotation(rotation, angular_velocity, 0, count, rotation_dt);
+}
+
+#ifdef INTEGRATE_SIMD_WIDTH
+void integrate_wrap(Vector2 *position, Vector2 *velocity, float *rotation, const float *angular_velocity, int count,
+                    float position_dt, float rotation_dt, Vector2 size, Vector2 max_velocity, Vec *wrapped)
+{
+    vec_clear(wrapped);
+    // Positions and velocities as flat floats, even lanes are x and odd lanes are y
+    float *p = (float *)position, *v = (float *)velocity;
+    int floats = 2 * count;
+    integrate_vf zero = INTEGRATE_ZERO(), dt = INTEGRATE_SET1(position_dt);
+    integrate_vf bound = INTEGRATE_SET_XY(size.x, size.y);
+    integrate_vf max_v = INTEGRATE_SET_XY(max_velocity.x, max_velocity.y), min_v = INTEGRATE_SUB(zero, max_v);
+    int i, k;
+    for (i = 0; i + INTEGRATE_SIMD_WIDTH <= floats; i += INTEGRATE_SIMD_WIDTH)
+    {
+        integrate_vf vel = INTEGRATE_LOAD(v + i);
+        integrate_vf pos = INTEGRATE_ADD(INTEGRATE_LOAD(p + i), INTEGRATE_MUL(vel, dt));
+        integrate_vf above = INTEGRATE_GT(pos, bound), below = INTEGRATE_LT(pos, zero);
+        INTEGRATE_STORE(p + i, INTEGRATE_SELECT(INTEGRATE_SELECT(pos, zero, above), bound, below));
+        INTEGRATE_STORE(v + i, INTEGRATE_MIN(INTEGRATE_MAX(vel, min_v), max_v));
+        unsigned int mask = (unsigned int)INTEGRATE_MOVEMASK(INTEGRATE_OR(above, below));
+        // Rare, most steps nothing wraps. Bits 2k and 2k + 1 belong to the same entity.
+        if (mask)
+        {
+            for (k = 0; k < INTEGRATE_SIMD_WIDTH / 2; k++)
+            {
+                if ((mask >> (2 * k)) & 3u)
+                {
+                    int entity = i / 2 + k;
+                    vec_push_back(wrapped, &entity);
+                }
+            }
+        }
+    }
+    integrate_wrap_entities(position, velocity, i / 2, count, position_dt, size, max_velocity, wrapped);
+
+    integrate_vf rotation_step = INTEGRATE_SET1(rotation_dt);
+    for (i = 0; i + INTEGRATE_SIMD_WIDTH <= count; i += INTEGRATE_SIMD_WIDTH)
+    {
+        INTEGRATE_STORE(rotation + i, INTEGRATE_ADD(INTEGRATE_LOAD(rotation + i), INTEGRATE_MUL(INTEGRATE_LOAD(angular_velocity + i), rotation_step)));
+    }
+    integrate_rotation(rotation, angular_velocity, i, count, rotation_dt);
+}
+#else
+void integrate_wrap(Vector2 *position, Vector2 *velocity, float *rotation, const float *angular_velocity, int count,
+                    float position_dt, float rotation_dt, Vector2 size, Vector2 max_velocity, Vec *wrapped)
+{
+    integrate_wrap_scalar(position, velocity, rotation, angular_velocity, count, position_dt, rotation_dt, size, max_velocity, wrapped);
+}
+#endif
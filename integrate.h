@@ -0,0 +1,48 @@
+/**
+ * @file integrate.h
+ * @brief Batch integration of entities stored as contiguous position, velocity and rotation arrays.
+ *
+ */
+
+#ifndef INTEGRATE_H_
+#define INTEGRATE_H_
+
+#include <raylib.h>
+#include "C-Collection-Vector/vector.h"
+
+/*
+    INFO:
+        One call moves a whole array of entities, wraps them around the field and clamps their
+        velocity without a branch per entity. Positions and velocities are read as flat arrays of
+        floats, so one SIMD lane holds one coordinate and the x and y lanes only differ in their bound.
+        Entities leaving the field re-enter on the opposite edge like return_to_screen does, and
+        their indices are reported so the caller can react to the wrap (asteroid_update re-kicks them).
+        The result is bit for bit the same as the per entity update it replaces, with or without SIMD.
+*/
+
+/**
+ * @brief Moves, wraps and clamps every entity of the arrays.
+ *
+ * @param position Positions, moved by velocity * position_dt and wrapped into [0, size].
+ * @param velocity Velocities, clamped to [-max_velocity, max_velocity] after the move.
+ * @param rotation Rotations, moved by angular_velocity * rotation_dt.
+ * @param angular_velocity Angular velocities.
+ * @param count Number of entities.
+ * @param position_dt Time step in velocity units.
+ * @param rotation_dt Time step in angular velocity units.
+ * @param size Size of the field.
+ * @param max_velocity Largest velocity on each axis.
+ * @param wrapped Vec of int, cleared and filled with the indices of the entities that wrapped in ascending order.
+ *
+ * @details Uses AVX or SSE2 lanes when the compiler targets them, integrate_wrap_scalar otherwise.
+ */
+void integrate_wrap(Vector2 *position, Vector2 *velocity, float *rotation, const float *angular_velocity, int count,
+                    float position_dt, float rotation_dt, Vector2 size, Vector2 max_velocity, Vec *wrapped);
+
+/**
+ * @brief Scalar fallback of integrate_wrap, same arguments and results.
+ */
+void integrate_wrap_scalar(Vector2 *position, Vector2 *velocity, float *rotation, const float *angular_velocity, int count,
+                           float position_dt, float rotation_dt, Vector2 size, Vector2 max_velocity, Vec *wrapped);
+
+#endif
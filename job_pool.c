@@ -0,0 +1,321 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "job_pool.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+typedef CRITICAL_SECTION JobMutex;
+typedef CONDITION_VARIABLE JobCond;
+typedef HANDLE JobThread;
+
+static void job_mutex_init(JobMutex *mutex) { InitializeCriticalSection(mutex); }
+static void job_mutex_destroy(JobMutex *mutex) { DeleteCriticalSection(mutex); }
+static void job_mutex_lock(JobMutex *mutex) { EnterCriticalSection(mutex); }
+static void job_mutex_unlock(JobMutex *mutex) { LeaveCriticalSection(mutex); }
+static void job_cond_init(JobCond *cond) { InitializeConditionVariable(cond); }
+static void job_cond_destroy(JobCond *cond) { (void)cond; }
+static void job_cond_wait(JobCond *cond, JobMutex *mutex) { SleepConditionVariableCS(cond, mutex, INFINITE); }
+static void job_cond_broadcast(JobCond *cond) { WakeAllConditionVariable(cond); }
+#else
+#include <pthread.h>
+#include <unistd.h>
+
+typedef pthread_mutex_t JobMutex;
+typedef pthread_cond_t JobCond;
+typedef pthread_t JobThread;
+
+static void job_mutex_init(JobMutex *mutex) { pthread_mutex_init(mutex, NULL); }
+static void job_mutex_destroy(JobMutex *mutex) { pthread_mutex_destroy(mutex); }
+static void job_mutex_lock(JobMutex *mutex) { pthread_mutex_lock(mutex); }
+static void job_mutex_unlock(JobMutex *mutex) { pthread_mutex_unlock(mutex); }
+static void job_cond_init(JobCond *cond) { pthread_cond_init(cond, NULL); }
+static void job_cond_destroy(JobCond *cond) { pthread_cond_destroy(cond); }
+static void job_cond_wait(JobCond *cond, JobMutex *mutex) { pthread_cond_wait(cond, mutex); }
+static void job_cond_broadcast(JobCond *cond) { pthread_cond_broadcast(cond); }
+#endif
+
+/* Chunks [head, tail) still waiting in one worker's deque */
+typedef struct
+{
+    JobMutex lock;
+    int head; /* thieves take from here */
+    int tail; /* the owner takes tail - 1 */
+} JobDeque;
+
+typedef struct
+{
+    JobPool *pool;
+    int index;
+} JobWorker;
+
+struct JobPool
+{
+    int worker_count;
+    JobThread *threads; /* worker_count - 1, worker 0 is the caller */
+    JobWorker *workers;
+    JobDeque *deques;
+    JobMutex lock; /* guards everything below */
+    JobCond work_cond;
+    JobCond done_cond;
+    unsigned int generation; /* bumped by every job_pool_parallel_for that wakes the threads */
+    int busy;                /* threads still working on a generation */
+    int chunks_done;
+    int chunk_count;
+    bool shutdown;
+    JobFunc func;
+    void *context;
+    int count;
+    int chunk_size;
+};
+
+static void *job_pool_calloc(size_t count, size_t size)
+{
+    void *ptr = calloc(count, size);
+    if (!ptr)
+    {
+        fprintf(stderr, "Failed to allocate memory for job pool\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+int job_pool_hardware_threads(void)
+{
+    int count;
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    count = (int)info.dwNumberOfProcessors;
+#else
+    count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (count < 1)
+        return 1;
+    if (count > JOB_POOL_MAX_WORKERS)
+        return JOB_POOL_MAX_WORKERS;
+    return count;
+}
+
+/* Returns the next chunk for worker, its own deque first, then the others in order. -1 when all are empty */
+static int job_pool_take(JobPool *pool, int worker)
+{
+    JobDeque *own = &pool->deques[worker];
+    int chunk = -1;
+    job_mutex_lock(&own->lock);
+    if (own->head < own->tail)
+    {
+        chunk = --own->tail;
+    }
+    job_mutex_unlock(&own->lock);
+    int i;
+    for (i = 1; chunk < 0 && i < pool->worker_count; i++)
+    {
+        JobDeque *victim = &pool->deques[(worker + i) % pool->worker_count];
+        job_mutex_lock(&victim->lock);
+        if (victim->head < victim->tail)
+        {
+            chunk = victim->head++;
+        }
+        job_mutex_unlock(&victim->lock);
+    }
+    return chunk;
+}
+
+/* Runs chunks until every deque is empty, returns the number of chunks run */
+static int job_pool_work(JobPool *pool, int worker, JobFunc func, void *context, int count, int chunk_size)
+{
+    int done = 0;
+    int chunk;
+    while ((chunk = job_pool_take(pool, worker)) >= 0)
+    {
+        int begin = chunk * chunk_size;
+        int end = begin + chunk_size < count ? begin + chunk_size : count;
+        func(context, begin, end, worker);
+        done++;
+    }
+    return done;
+}
+
+static void job_pool_thread_main(JobWorker *worker)
+{
+    JobPool *pool = worker->pool;
+    unsigned int seen = 0;
+    job_mutex_lock(&pool->lock);
+    for (;;)
+    {
+        while (!pool->shutdown && pool->generation == seen)
+        {
+            job_cond_wait(&pool->work_cond, &pool->lock);
+        }
+        if (pool->shutdown)
+        {
+            break;
+        }
+        seen = pool->generation;
+        pool->busy++;
+        /* The job can not change while busy is not 0, see job_pool_parallel_for */
+        JobFunc func = pool->func;
+        void *context = pool->context;
+        int count = pool->count;
+        int chunk_size = pool->chunk_size;
+        job_mutex_unlock(&pool->lock);
+        int done = job_pool_work(pool, worker->index, func, context, count, chunk_size);
+        job_mutex_lock(&pool->lock);
+        pool->chunks_done += done;
+        pool->busy--;
+        job_cond_broadcast(&pool->done_cond);
+    }
+    job_mutex_unlock(&pool->lock);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI job_pool_thread_entry(LPVOID arg)
+{
+    job_pool_thread_main((JobWorker *)arg);
+    return 0;
+}
+#else
+static void *job_pool_thread_entry(void *arg)
+{
+    job_pool_thread_main((JobWorker *)arg);
+    return NULL;
+}
+#endif
+
+JobPool *job_pool_new(int worker_count)
+{
+    if (worker_count <= 0)
+    {
+        worker_count = job_pool_hardware_threads();
+    }
+    if (worker_count > JOB_POOL_MAX_WORKERS)
+    {
+        worker_count = JOB_POOL_MAX_WORKERS;
+    }
+    JobPool *pool = (JobPool *)job_pool_calloc(1, sizeof(JobPool));
+    pool->worker_count = worker_count;
+    pool->workers = (JobWorker *)job_pool_calloc(worker_count, sizeof(JobWorker));
+    pool->deques = (JobDeque *)job_pool_calloc(worker_count, sizeof(JobDeque));
+    job_mutex_init(&pool->lock);
+    job_cond_init(&pool->work_cond);
+    job_cond_init(&pool->done_cond);
+    int i;
+    for (i = 0; i < worker_count; i++)
+    {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+        job_mutex_init(&pool->deques[i].lock);
+    }
+    if (worker_count > 1)
+    {
+        pool->threads = (JobThread *)job_pool_calloc(worker_count - 1, sizeof(JobThread));
+    }
+    for (i = 1; i < worker_count; i++)
+    {
+#ifdef _WIN32
+        pool->threads[i - 1] = CreateThread(NULL, 0, job_pool_thread_entry, &pool->workers[i], 0, NULL);
+        bool failed = pool->threads[i - 1] == NULL;
+#else
+        bool failed = pthread_create(&pool->threads[i - 1], NULL, job_pool_thread_entry, &pool->workers[i]) != 0;
+#endif
+        if (failed)
+        {
+            fprintf(stderr, "Failed to create job pool thread\n");
+            exit(1);
+        }
+    }
+    return pool;
+}
+
+void job_pool_free(JobPool *pool)
+{
+    if (!pool)
+        return;
+    job_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    job_cond_broadcast(&pool->work_cond);
+    job_mutex_unlock(&pool->lock);
+    int i;
+    for (i = 0; i < pool->worker_count - 1; i++)
+    {
+#ifdef _WIN32
+        WaitForSingleObject(pool->threads[i], INFINITE);
+        CloseHandle(pool->threads[i]);
+#else
+        pthread_join(pool->threads[i], NULL);
+#endif
+    }
+    for (i = 0; i < pool->worker_count; i++)
+    {
+        job_mutex_destroy(&pool->deques[i].lock);
+    }
+    job_cond_destroy(&pool->work_cond);
+    job_cond_destroy(&pool->done_cond);
+    job_mutex_destroy(&pool->lock);
+    free(pool->threads);
+    free(pool->workers);
+    free(pool->deques);
+    free(pool);
+}
+
+int job_pool_worker_count(JobPool *pool)
+{
+    return pool->worker_count;
+}
+
+void job_pool_parallel_for(JobPool *pool, int count, int chunk_size, JobFunc func, void *context)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+    if (chunk_size < 1)
+    {
+        chunk_size = 1;
+    }
+    int chunk_count = (count + chunk_size - 1) / chunk_size;
+    if (pool->worker_count == 1 || chunk_count == 1)
+    {
+        int begin;
+        for (begin = 0; begin < count; begin += chunk_size)
+        {
+            func(context, begin, begin + chunk_size < count ? begin + chunk_size : count, 0);
+        }
+        return;
+    }
+    job_mutex_lock(&pool->lock);
+    /* A thread that woke up late for the previous job may still be scanning the empty deques */
+    while (pool->busy > 0)
+    {
+        job_cond_wait(&pool->done_cond, &pool->lock);
+    }
+    pool->func = func;
+    pool->context = context;
+    pool->count = count;
+    pool->chunk_size = chunk_size;
+    pool->chunk_count = chunk_count;
+    pool->chunks_done = 0;
+    int i;
+    for (i = 0; i < pool->worker_count; i++)
+    {
+        /* No thread is busy, so the deques can be filled without their locks */
+        pool->deques[i].head = (int)((long long)chunk_count * i / pool->worker_count);
+        pool->deques[i].tail = (int)((long long)chunk_count * (i + 1) / pool->worker_count);
+    }
+    pool->generation++;
+    job_cond_broadcast(&pool->work_cond);
+    job_mutex_unlock(&pool->lock);
+
+    int done = job_pool_work(pool, 0, func, context, count, chunk_size);
+
+    job_mutex_lock(&pool->lock);
+    pool->chunks_done += done;
+    while (pool->chunks_done < pool->chunk_count || pool->busy > 0)
+    {
+        job_cond_wait(&pool->done_cond, &pool->lock);
+    }
+    job_mutex_unlock(&pool->lock);
+}
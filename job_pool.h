@@ -0,0 +1,81 @@
+/**
+ * @file job_pool.h
+ * @brief Work-stealing thread pool for data parallel loops.
+ *
+ */
+
+#ifndef JOB_POOL_H_
+#define JOB_POOL_H_
+
+/*
+    INFO:
+        The calling thread is worker 0 and works on every job, worker_count - 1 threads are created.
+        job_pool_parallel_for splits [0, count) into chunks of chunk_size and deals a contiguous run of
+        chunks to every worker's deque. Workers take chunks from the back of their own deque and steal
+        from the front of the other deques once theirs is empty.
+        Which worker runs a chunk is not deterministic, so jobs that need a deterministic result have to
+        key their output by index and merge it afterwards, the worker index only selects a scratch buffer.
+        JobPool is opaque because it holds the platform thread types, job_pool.c includes windows.h
+        or pthread.h and must not include raylib.h.
+*/
+
+/* Upper bound of workers, also used when the hardware reports more threads */
+#define JOB_POOL_MAX_WORKERS 64
+
+/**
+ * @brief Runs the items [begin, end) of a job.
+ *
+ * @param context Pointer passed to job_pool_parallel_for.
+ * @param begin First item.
+ * @param end One past the last item.
+ * @param worker Index of the worker running the chunk, in [0, job_pool_worker_count).
+ */
+typedef void (*JobFunc)(void *context, int begin, int end, int worker);
+
+typedef struct JobPool JobPool;
+
+/**
+ * @brief Returns the number of hardware threads, at least 1.
+ *
+ * @return int
+ */
+int job_pool_hardware_threads(void);
+
+/**
+ * @brief Creates a pool and starts its threads.
+ *
+ * @param worker_count Number of workers including the calling thread, 0 or less uses job_pool_hardware_threads.
+ * @return JobPool*
+ */
+JobPool *job_pool_new(int worker_count);
+
+/**
+ * @brief Stops and joins every thread and frees the pool.
+ *
+ * @param pool Pool to free.
+ */
+void job_pool_free(JobPool *pool);
+
+/**
+ * @brief Returns the number of workers including the calling thread.
+ *
+ * @param pool Pool to query.
+ * @return int
+ */
+int job_pool_worker_count(JobPool *pool);
+
+/**
+ * @brief Calls func on every chunk of [0, count) and returns once all chunks are done.
+ *
+ * @param pool Pool to run on.
+ * @param count Number of items.
+ * @param chunk_size Items per chunk, the last chunk can be smaller.
+ * @param func Function run on every chunk.
+ * @param context Passed to func.
+ *
+ * @details A job with a single chunk, or a pool with a single worker, runs on the calling thread
+ * without waking the other threads. Must not be called from inside a job.
+ */
+void job_pool_parallel_for(JobPool *pool, int count, int chunk_size, JobFunc func, void *context);
+
+#endif
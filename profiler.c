@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include "profiler.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+static unsigned long long profiler_clock(void)
+{
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (!frequency.QuadPart)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    /* Split so the multiplication does not overflow after a few hours */
+    unsigned long long seconds = (unsigned long long)(counter.QuadPart / frequency.QuadPart);
+    unsigned long long rest = (unsigned long long)(counter.QuadPart % frequency.QuadPart);
+    return seconds * 1000000000ull + rest * 1000000000ull / (unsigned long long)frequency.QuadPart;
+}
+#else
+#include <time.h>
+
+/* C11 wall clock like headless and bench, clock_gettime would need POSIX or GNU extensions */
+static unsigned long long profiler_clock(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+#endif
+
+#define PROFILER_EVENT_MASK (PROFILER_MAX_EVENTS - 1)
+
+/*
+    Events are addressed by a sequence number that only grows, event n lives in slot n & PROFILER_EVENT_MASK
+    and is still in the ring while written - n <= PROFILER_MAX_EVENTS.
+*/
+typedef struct
+{
+    ProfilerEvent events[PROFILER_MAX_EVENTS];
+    unsigned long long written;                /* events ever begun */
+    unsigned long long open[PROFILER_MAX_DEPTH]; /* sequence numbers of the open zones */
+    int depth;
+    int skipped_depth; /* zones opened past PROFILER_MAX_DEPTH that are not recorded */
+    unsigned int frame;
+    unsigned long long origin;
+    unsigned long long frame_first; /* first event of the current frame */
+    unsigned long long frame_start;
+    unsigned long long last_first; /* events [last_first, last_end) belong to the last complete frame */
+    unsigned long long last_end;
+    unsigned long long last_length;
+} Profiler;
+
+static Profiler profiler;
+
+static bool profiler_in_ring(unsigned long long sequence)
+{
+    return profiler.written - sequence <= PROFILER_MAX_EVENTS;
+}
+
+unsigned long long profiler_now(void)
+{
+    if (!profiler.origin)
+    {
+        profiler.origin = profiler_clock();
+    }
+    return profiler_clock() - profiler.origin;
+}
+
+void profiler_frame(void)
+{
+    unsigned long long now = profiler_now();
+    if (profiler.frame > 0)
+    {
+        profiler.last_first = profiler.frame_first;
+        profiler.last_end = profiler.written;
+        profiler.last_length = now - profiler.frame_start;
+    }
+    profiler.frame++;
+    profiler.frame_first = profiler.written;
+    profiler.frame_start = now;
+}
+
+void profiler_begin(const char *name)
+{
+    if (profiler.depth == PROFILER_MAX_DEPTH)
+    {
+        profiler.skipped_depth++;
+        return;
+    }
+    ProfilerEvent *event = &profiler.events[profiler.written & PROFILER_EVENT_MASK];
+    event->name = name;
+    event->frame = profiler.frame;
+    event->depth = profiler.depth;
+    event->start = profiler_now();
+    event->end = event->start;
+    profiler.open[profiler.depth++] = profiler.written++;
+}
+
+void profiler_end(void)
+{
+    unsigned long long now = profiler_now();
+    if (profiler.skipped_depth > 0)
+    {
+        profiler.skipped_depth--;
+        return;
+    }
+    if (profiler.depth == 0)
+    {
+        return;
+    }
+    unsigned long long sequence = profiler.open[--profiler.depth];
+    if (profiler_in_ring(sequence))
+    {
+        profiler.events[sequence & PROFILER_EVENT_MASK].end = now;
+    }
+}
+
+int profiler_summarize(ProfilerSummary *rows, int max_rows, double *frame_milliseconds)
+{
+    unsigned long long sequence = profiler.last_first;
+    int count = 0;
+    int i;
+    if (!profiler_in_ring(sequence))
+    {
+        sequence = profiler.written - PROFILER_MAX_EVENTS;
+    }
+    for (; sequence < profiler.last_end; sequence++)
+    {
+        ProfilerEvent *event = &profiler.events[sequence & PROFILER_EVENT_MASK];
+        /* Names are compared by pointer, the same literal always has the same address */
+        for (i = 0; i < count; i++)
+        {
+            if (rows[i].name == event->name && rows[i].depth == event->depth)
+            {
+                break;
+            }
+        }
+        if (i == count)
+        {
+            if (count == max_rows)
+            {
+                continue;
+            }
+            rows[count].name = event->name;
+            rows[count].depth = event->depth;
+            rows[count].calls = 0;
+            rows[count].milliseconds = 0;
+            count++;
+        }
+        rows[i].calls++;
+        rows[i].milliseconds += (double)(event->end - event->start) * 1e-6;
+    }
+    if (frame_milliseconds)
+    {
+        *frame_milliseconds = (double)profiler.last_length * 1e-6;
+    }
+    return count;
+}
+
+static bool profiler_is_open(unsigned long long sequence)
+{
+    int i;
+    for (i = 0; i < profiler.depth; i++)
+    {
+        if (profiler.open[i] == sequence)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool profiler_write_chrome_trace(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        fprintf(stderr, "Failed to open %s for the trace\n", path);
+        return false;
+    }
+    unsigned long long sequence = profiler.written > PROFILER_MAX_EVENTS ? profiler.written - PROFILER_MAX_EVENTS : 0;
+    bool first = true;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (; sequence < profiler.written; sequence++)
+    {
+        ProfilerEvent *event = &profiler.events[sequence & PROFILER_EVENT_MASK];
+        const char *c;
+        if (profiler_is_open(sequence))
+        {
+            continue;
+        }
+        fprintf(file, "%s\n{\"name\":\"", first ? "" : ",");
+        for (c = event->name; *c; c++)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                fputc('\\', file);
+            }
+            fputc(*c, file);
+        }
+        /* Complete events, times in microseconds */
+        fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}}", (double)event->start * 1e-3, (double)(event->end - event->start) * 1e-3, event->frame);
+        first = false;
+    }
+    fprintf(file, "\n]}\n");
+    bool ok = !ferror(file);
+    if (fclose(file) != 0)
+    {
+        ok = false;
+    }
+    return ok;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file profiler.h
+ * @brief Hierarchical frame profiler, scoped timing zones recorded into a ring buffer.
+ * The last frame is summarized for an in-game overlay and the whole buffer can be written as
+ * Chrome trace event JSON for chrome://tracing or Perfetto.
+ *
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdbool.h>
+
+/*
+    INFO:
+        PROFILE_BEGIN(name) and PROFILE_END() bracket a zone, zones nest and every PROFILE_BEGIN
+        needs exactly one PROFILE_END on the same path, also before an early return.
+        Names must be string literals or otherwise outlive the profiler, only the pointer is stored.
+        The macros compile to nothing unless PROFILER_ENABLED is 1, it defaults to 1 without NDEBUG
+        so debug builds profile and release builds pay nothing. The functions stay available in both
+        builds so the front ends do not need their own #if, without zones they only see empty frames.
+        The profiler is a single global instance and is not thread safe, zones may only be opened by
+        the main thread. Jobs on the pool are timed as one zone around job_pool_parallel_for.
+        Once the ring is full the oldest events are overwritten, a zone still open when its slot is
+        reused is lost and its PROFILE_END is ignored.
+*/
+
+#ifndef PROFILER_ENABLED
+#ifdef NDEBUG
+#define PROFILER_ENABLED 0
+#else
+#define PROFILER_ENABLED 1
+#endif
+#endif
+
+/* Events kept in the ring, a power of two */
+#define PROFILER_MAX_EVENTS 65536
+/* Zones open at the same time, deeper zones are not recorded */
+#define PROFILER_MAX_DEPTH 32
+
+#if PROFILER_ENABLED
+#define PROFILE_BEGIN(name) profiler_begin(name)
+#define PROFILE_END() profiler_end()
+#else
+#define PROFILE_BEGIN(name) ((void)0)
+#define PROFILE_END() ((void)0)
+#endif
+
+typedef struct
+{
+    const char *name;
+    unsigned long long start; /* nanoseconds since the profiler started */
+    unsigned long long end;   /* equal to start while the zone is open */
+    unsigned int frame;
+    int depth; /* 0 for zones opened outside any other zone */
+} ProfilerEvent;
+
+/* Time of every zone with the same name and depth in one frame */
+typedef struct
+{
+    const char *name;
+    int depth;
+    int calls;
+    double milliseconds;
+} ProfilerSummary;
+
+/**
+ * @brief Nanoseconds of a monotonic clock since the first call.
+ *
+ * @return unsigned long long
+ */
+unsigned long long profiler_now(void);
+
+/**
+ * @brief Ends the current frame and starts the next one.
+ *
+ * @details Call once per frame outside of any zone, profiler_summarize reads the frame ended here.
+ */
+void profiler_frame(void);
+
+/**
+ * @brief Opens a zone, use PROFILE_BEGIN instead so release builds compile it out.
+ *
+ * @param name Zone name, only the pointer is stored.
+ */
+void profiler_begin(const char *name);
+
+/**
+ * @brief Closes the zone opened last, use PROFILE_END instead.
+ */
+void profiler_end(void);
+
+/**
+ * @brief Sums the zones of the last complete frame by name and depth.
+ *
+ * @param rows Array of summaries to fill, in the order the zones were first opened.
+ * @param max_rows Size of rows, further zones are left out.
+ * @param frame_milliseconds Set to the length of the frame. Can be NULL.
+ * @return int Number of rows written.
+ */
+int profiler_summarize(ProfilerSummary *rows, int max_rows, double *frame_milliseconds);
+
+/**
+ * @brief Writes every closed zone still in the ring as Chrome trace event JSON.
+ *
+ * @param path File to write.
+ * @return true if the file was written.
+ */
+bool profiler_write_chrome_trace(const char *path);
+
+#endif
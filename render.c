@@ -0,0 +1,158 @@
+#include <raylib.h>
+#include <raymath.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "render.h"
+
+#define LINE_BATCH_MIN_CAPACITY 1024
+
+static void *line_batch_realloc(void *ptr, size_t size)
+{
+    void *new_ptr = realloc(ptr, size);
+    if (!new_ptr)
+    {
+        fprintf(stderr, "Failed to allocate memory for line batch\n");
+        exit(1);
+    }
+    return new_ptr;
+}
+
+LineBatch *line_batch_new(void)
+{
+    LineBatch *batch = (LineBatch *)line_batch_realloc(NULL, sizeof(LineBatch));
+    batch->capacity = LINE_BATCH_MIN_CAPACITY;
+    batch->count = 0;
+    batch->vertices = (LineVertex *)line_batch_realloc(NULL, batch->capacity * sizeof(LineVertex));
+    return batch;
+}
+
+void line_batch_free(LineBatch *batch)
+{
+    if (!batch)
+        return;
+    free(batch->vertices);
+    free(batch);
+}
+
+void line_batch_clear(LineBatch *batch)
+{
+    batch->count = 0;
+}
+
+static void line_batch_reserve(LineBatch *batch, int count)
+{
+    if (batch->count + count <= batch->capacity)
+    {
+        return;
+    }
+    while (batch->count + count > batch->capacity)
+    {
+        batch->capacity *= 2;
+    }
+    batch->vertices = (LineVertex *)line_batch_realloc(batch->vertices, batch->capacity * sizeof(LineVertex));
+}
+
+void line_batch_add_polygon(LineBatch *batch, const Vector2 *points, int count, float thickness, Color color)
+{
+    line_batch_reserve(batch, count * LINE_BATCH_VERTICES_PER_EDGE);
+    LineVertex *out = &batch->vertices[batch->count];
+    float half = thickness * 0.5f;
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        Vector2 a = points[i];
+        Vector2 b = points[i + 1 < count ? i + 1 : 0];
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        float length = sqrtf(dx * dx + dy * dy);
+        if (length <= 0)
+        {
+            continue;
+        }
+        /* Half the thickness along the edge normal */
+        Vector2 n = {-dy / length * half, dx / length * half};
+        Vector2 a0 = {a.x + n.x, a.y + n.y};
+        Vector2 a1 = {a.x - n.x, a.y - n.y};
+        Vector2 b0 = {b.x + n.x, b.y + n.y};
+        Vector2 b1 = {b.x - n.x, b.y - n.y};
+        /* Counter-clockwise on screen like raylib's own triangles, so backface culling keeps them */
+        out[0] = (LineVertex){a0, color};
+        out[1] = (LineVertex){b1, color};
+        out[2] = (LineVertex){a1, color};
+        out[3] = (LineVertex){a0, color};
+        out[4] = (LineVertex){b0, color};
+        out[5] = (LineVertex){b1, color};
+        out += LINE_BATCH_VERTICES_PER_EDGE;
+    }
+    batch->count = (int)(out - batch->vertices);
+}
+
+void line_batch_add_shape(LineBatch *batch, const Vector2 *points, int count, Vector2 position, float rotation, float thickness, Color color)
+{
+    Vector2 world_points[SHAPE_MAX_POINTS];
+    float s = sinf(DEG2RAD * rotation);
+    float c = cosf(DEG2RAD * rotation);
+    int i;
+    if (count > SHAPE_MAX_POINTS)
+    {
+        count = SHAPE_MAX_POINTS;
+    }
+    for (i = 0; i < count; i++)
+    {
+        world_points[i] = (Vector2){position.x + points[i].x * c - points[i].y * s, position.y + points[i].x * s + points[i].y * c};
+    }
+    line_batch_add_polygon(batch, world_points, count, thickness, color);
+}
+
+float interpolation_factor(Vector2 previous, Vector2 current, Vector2 size, float alpha)
+{
+    if (fabsf(current.x - previous.x) > size.x / 2 || fabsf(current.y - previous.y) > size.y / 2)
+    {
+        return 1.0f;
+    }
+    return alpha;
+}
+
+void render_world(LineBatch *batch, World *world, float alpha, bool draw_hitbox)
+{
+    AsteroidStore *store = world->asteroids;
+    int i;
+    size_t j;
+    for (i = 0; i < store->count; i++)
+    {
+        const AsteroidShape *shape = asteroid_store_shape(store, i);
+        float t = interpolation_factor(store->previous_position[i], store->position[i], world->size, alpha);
+        float rotation = Lerp(store->previous_rotation[i], store->rotation[i], t);
+        Vector2 center = Vector2Add(Vector2Lerp(store->previous_position[i], store->position[i], t), shape->center);
+        if (draw_hitbox)
+        {
+            line_batch_add_shape(batch, shape->hitshape, ASTEROID_HITSHAPE_POINTS, center, rotation, LINE_THICKNESS, store->color[i]);
+        }
+        line_batch_add_shape(batch, shape->outline, ASTEROID_POINTS, center, rotation, LINE_THICKNESS, WHITE);
+    }
+    for (j = 0; j < projectile_vec_size(world->projectile_vec); j++)
+    {
+        EntityData *entity = &projectile_vec_at(world->projectile_vec, j)->entity;
+        float t = interpolation_factor(entity->previous_position, entity->position, world->size, alpha);
+        const ShapePrototype *shape = shape_prototype(entity->hitshape.shape);
+        Vector2 center = Vector2Add(Vector2Lerp(entity->previous_position, entity->position, t), shape->center);
+        line_batch_add_shape(batch, shape->points, shape->num_points, center, entity->rotation, LINE_THICKNESS, WHITE);
+    }
+    Ship *ship = &world->ship;
+    float t = interpolation_factor(ship->entity.previous_position, ship->entity.position, world->size, alpha);
+    float rotation = Lerp(ship->entity.previous_rotation, ship->entity.rotation, t);
+    const ShapePrototype *hitshape = shape_prototype(ship->entity.hitshape.shape);
+    const ShapePrototype *body = shape_prototype(SHAPE_SHIP_BODY);
+    const ShapePrototype *trail = shape_prototype(SHAPE_SHIP_TRAIL);
+    Vector2 center = Vector2Add(Vector2Lerp(ship->entity.previous_position, ship->entity.position, t), hitshape->center);
+    if (ship->state.draw_trail)
+    {
+        line_batch_add_shape(batch, trail->points, trail->num_points, center, rotation, LINE_THICKNESS, RED);
+    }
+    line_batch_add_shape(batch, body->points, body->num_points, center, rotation, LINE_THICKNESS, WHITE);
+    if (draw_hitbox)
+    {
+        line_batch_add_shape(batch, hitshape->points, hitshape->num_points, center, rotation, LINE_THICKNESS, ship->entity.hitshape.color);
+    }
+}
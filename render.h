@@ -0,0 +1,103 @@
+/**
+ * @file render.h
+ * @brief Builds one interleaved triangle list with every outline of the world, so a frame
+ * is drawn with a few large batches instead of one draw call per edge.
+ *
+ */
+
+#ifndef RENDER_H_
+#define RENDER_H_
+
+#include <stdbool.h>
+#include <raylib.h>
+#include "world.h"
+
+/*
+    INFO:
+        Vertex generation never calls raylib, it only fills a LineBatch, so it runs and can be checked
+        without a window. The front end submits the batch, see draw_line_batch in main.c.
+        Every edge becomes a quad of two triangles, 6 vertices, LINE_THICKNESS wide.
+        Shapes are transformed with one sin/cos per shape and every vertex is rotated once,
+        then shared by the two edges that meet at it.
+*/
+
+#define LINE_THICKNESS 2
+#define LINE_BATCH_VERTICES_PER_EDGE 6
+
+/* Interleaved position and color, the layout rlgl takes per vertex */
+typedef struct
+{
+    Vector2 position;
+    Color color;
+} LineVertex;
+
+typedef struct
+{
+    LineVertex *vertices; /* triangle list, count is a multiple of 3 */
+    int count;
+    int capacity;
+} LineBatch;
+
+/**
+ * @brief Creates an empty batch.
+ *
+ * @return LineBatch*
+ */
+LineBatch *line_batch_new(void);
+
+/**
+ * @brief Frees the batch and its vertices.
+ *
+ * @param batch Batch to free.
+ */
+void line_batch_free(LineBatch *batch);
+
+/**
+ * @brief Removes every vertex, the memory is kept for the next frame.
+ *
+ * @param batch Batch to clear.
+ */
+void line_batch_clear(LineBatch *batch);
+
+/**
+ * @brief Adds the edges of a closed polygon given in world space.
+ *
+ * @param batch Batch to add to.
+ * @param points World space vertices.
+ * @param count Number of vertices.
+ * @param thickness Line width.
+ * @param color Line color.
+ */
+void line_batch_add_polygon(LineBatch *batch, const Vector2 *points, int count, float thickness, Color color);
+
+/**
+ * @brief Rotates and translates a local space closed polygon and adds its edges.
+ *
+ * @param batch Batch to add to.
+ * @param points Local space vertices, at most SHAPE_MAX_POINTS.
+ * @param count Number of vertices.
+ * @param position World position of the shape center.
+ * @param rotation Rotation in degrees.
+ * @param thickness Line width.
+ * @param color Line color.
+ */
+void line_batch_add_shape(LineBatch *batch, const Vector2 *points, int count, Vector2 position, float rotation, float thickness, Color color);
+
+/**
+ * @brief Returns the blend factor between an entity's previous and current tick.
+ *
+ * @return float alpha, or 1 when the entity wrapped around the screen so it does not streak across it.
+ */
+float interpolation_factor(Vector2 previous, Vector2 current, Vector2 size, float alpha);
+
+/**
+ * @brief Adds the outlines of every asteroid, projectile and the ship.
+ *
+ * @param batch Batch to add to, it is not cleared.
+ * @param world World to draw.
+ * @param alpha Interpolation between the previous and current tick, see timestep_alpha.
+ * @param draw_hitbox Also add the hitshapes, colored by the last collision pass.
+ */
+void render_world(LineBatch *batch, World *world, float alpha, bool draw_hitbox);
+
+#endif
@@ -0,0 +1,226 @@
+#include <stdlib.h>
+#include <string.h>
+#include "replay.h"
+
+static const unsigned char replay_magic[4] = {'A', 'S', 'R', 'P'};
+
+static void *replay_calloc(size_t count, size_t size)
+{
+    void *ptr = calloc(count, size);
+    if (!ptr)
+    {
+        fprintf(stderr, "Failed to allocate memory for replay\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+/* Values are written byte by byte so logs move between machines of any endianness */
+static void replay_write_u16(FILE *file, unsigned int value)
+{
+    unsigned char bytes[2] = {(unsigned char)value, (unsigned char)(value >> 8)};
+    fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+static void replay_write_u32(FILE *file, unsigned int value)
+{
+    unsigned char bytes[4] = {(unsigned char)value, (unsigned char)(value >> 8), (unsigned char)(value >> 16), (unsigned char)(value >> 24)};
+    fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+static void replay_write_f32(FILE *file, float value)
+{
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    replay_write_u32(file, bits);
+}
+
+static bool replay_read_u16(FILE *file, unsigned int *value)
+{
+    unsigned char bytes[2];
+    if (fread(bytes, 1, sizeof(bytes), file) != sizeof(bytes))
+    {
+        return false;
+    }
+    *value = bytes[0] | (unsigned int)bytes[1] << 8;
+    return true;
+}
+
+static bool replay_read_u32(FILE *file, unsigned int *value)
+{
+    unsigned char bytes[4];
+    if (fread(bytes, 1, sizeof(bytes), file) != sizeof(bytes))
+    {
+        return false;
+    }
+    *value = bytes[0] | (unsigned int)bytes[1] << 8 | (unsigned int)bytes[2] << 16 | (unsigned int)bytes[3] << 24;
+    return true;
+}
+
+static bool replay_read_f32(FILE *file, float *value)
+{
+    unsigned int bits;
+    if (!replay_read_u32(file, &bits))
+    {
+        return false;
+    }
+    memcpy(value, &bits, sizeof(bits));
+    return true;
+}
+
+Replay *replay_record_open(const char *path, const ReplayHeader *header)
+{
+    FILE *file = fopen(path, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "Failed to open %s for the replay\n", path);
+        return NULL;
+    }
+    Replay *replay = (Replay *)replay_calloc(1, sizeof(Replay));
+    replay->file = file;
+    replay->recording = true;
+    replay->header = *header;
+    replay->size = header->size;
+    replay->dt = header->dt;
+    fwrite(replay_magic, 1, sizeof(replay_magic), file);
+    replay_write_u32(file, REPLAY_VERSION);
+    replay_write_u32(file, header->seed);
+    replay_write_u32(file, header->asteroids);
+    replay_write_f32(file, header->size.x);
+    replay_write_f32(file, header->size.y);
+    replay_write_f32(file, header->dt);
+    return replay;
+}
+
+void replay_record_tick(Replay *replay, float dt, Vector2 size, const WorldInputs *inputs)
+{
+    unsigned int flags = 0;
+    flags |= inputs->rotate_left ? REPLAY_FLAG_ROTATE_LEFT : 0;
+    flags |= inputs->rotate_right ? REPLAY_FLAG_ROTATE_RIGHT : 0;
+    flags |= inputs->thrust ? REPLAY_FLAG_THRUST : 0;
+    flags |= inputs->brake ? REPLAY_FLAG_BRAKE : 0;
+    flags |= inputs->shoot ? REPLAY_FLAG_SHOOT : 0;
+    flags |= inputs->drag ? REPLAY_FLAG_DRAG : 0;
+    flags |= inputs->paused ? REPLAY_FLAG_PAUSED : 0;
+    /* Compared bitwise, a value that only compares equal would not replay bit for bit */
+    flags |= memcmp(&size, &replay->size, sizeof(Vector2)) != 0 ? REPLAY_FLAG_SIZE : 0;
+    flags |= memcmp(&dt, &replay->dt, sizeof(float)) != 0 ? REPLAY_FLAG_DT : 0;
+    replay_write_u16(replay->file, flags);
+    if (flags & REPLAY_FLAG_DRAG)
+    {
+        replay_write_f32(replay->file, inputs->drag_position.x);
+        replay_write_f32(replay->file, inputs->drag_position.y);
+    }
+    if (flags & REPLAY_FLAG_SIZE)
+    {
+        replay_write_f32(replay->file, size.x);
+        replay_write_f32(replay->file, size.y);
+        replay->size = size;
+    }
+    if (flags & REPLAY_FLAG_DT)
+    {
+        replay_write_f32(replay->file, dt);
+        replay->dt = dt;
+    }
+    replay->ticks++;
+}
+
+Replay *replay_play_open(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        fprintf(stderr, "Failed to open %s for the replay\n", path);
+        return NULL;
+    }
+    unsigned char magic[4];
+    unsigned int version = 0;
+    ReplayHeader header;
+    bool ok = fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, replay_magic, sizeof(magic)) == 0;
+    ok = ok && replay_read_u32(file, &version) && version == REPLAY_VERSION;
+    ok = ok && replay_read_u32(file, &header.seed) && replay_read_u32(file, &header.asteroids);
+    ok = ok && replay_read_f32(file, &header.size.x) && replay_read_f32(file, &header.size.y) && replay_read_f32(file, &header.dt);
+    if (!ok)
+    {
+        fprintf(stderr, "%s is not a replay of version %d\n", path, REPLAY_VERSION);
+        fclose(file);
+        return NULL;
+    }
+    Replay *replay = (Replay *)replay_calloc(1, sizeof(Replay));
+    replay->file = file;
+    replay->header = header;
+    replay->size = header.size;
+    replay->dt = header.dt;
+    return replay;
+}
+
+World *replay_world_new(const Replay *replay, int thread_count)
+{
+    World *world = world_new(replay->header.size, replay->header.seed, thread_count);
+    world_add_asteroids(world, (int)replay->header.asteroids);
+    return world;
+}
+
+bool replay_play_tick(Replay *replay, float *dt, Vector2 *size, WorldInputs *inputs)
+{
+    unsigned int flags;
+    if (replay->finished || !replay_read_u16(replay->file, &flags))
+    {
+        return false;
+    }
+    if (flags & REPLAY_FLAG_END)
+    {
+        unsigned int ticks;
+        replay->finished = replay_read_u32(replay->file, &ticks) && replay_read_u32(replay->file, &replay->checksum) && (int)ticks == replay->ticks;
+        return false;
+    }
+    memset(inputs, 0, sizeof(WorldInputs));
+    inputs->rotate_left = (flags & REPLAY_FLAG_ROTATE_LEFT) != 0;
+    inputs->rotate_right = (flags & REPLAY_FLAG_ROTATE_RIGHT) != 0;
+    inputs->thrust = (flags & REPLAY_FLAG_THRUST) != 0;
+    inputs->brake = (flags & REPLAY_FLAG_BRAKE) != 0;
+    inputs->shoot = (flags & REPLAY_FLAG_SHOOT) != 0;
+    inputs->drag = (flags & REPLAY_FLAG_DRAG) != 0;
+    inputs->paused = (flags & REPLAY_FLAG_PAUSED) != 0;
+    bool ok = true;
+    if (flags & REPLAY_FLAG_DRAG)
+    {
+        ok = ok && replay_read_f32(replay->file, &inputs->drag_position.x) && replay_read_f32(replay->file, &inputs->drag_position.y);
+    }
+    if (flags & REPLAY_FLAG_SIZE)
+    {
+        ok = ok && replay_read_f32(replay->file, &replay->size.x) && replay_read_f32(replay->file, &replay->size.y);
+    }
+    if (flags & REPLAY_FLAG_DT)
+    {
+        ok = ok && replay_read_f32(replay->file, &replay->dt);
+    }
+    if (!ok)
+    {
+        return false;
+    }
+    *dt = replay->dt;
+    *size = replay->size;
+    replay->ticks++;
+    return true;
+}
+
+bool replay_close(Replay *replay, const World *world)
+{
+    bool ok;
+    if (replay->recording)
+    {
+        replay_write_u16(replay->file, REPLAY_FLAG_END);
+        replay_write_u32(replay->file, (unsigned int)replay->ticks);
+        replay_write_u32(replay->file, world_checksum(world));
+        ok = !ferror(replay->file);
+        ok = fclose(replay->file) == 0 && ok;
+    }
+    else
+    {
+        ok = replay->finished && replay->checksum == world_checksum(world);
+        fclose(replay->file);
+    }
+    free(replay);
+    return ok;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file replay.h
+ * @brief Records the inputs of a game into a compact binary log and plays them back.
+ * The world is deterministic, so a log reproduces the game bit for bit, windowed or headless.
+ *
+ */
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <raylib.h>
+#include "world.h"
+
+/*
+    INFO:
+        Everything world_step depends on comes from the seed, the field size, the tick length and the
+        WorldInputs of every tick, the log stores exactly that. Frame times are not stored, the fixed timestep
+        already turned them into whole ticks and a player runs the ticks as fast as it wants.
+        Layout, every value little endian:
+            header  "ASRP", u32 version, u32 seed, u32 asteroids, f32 width, f32 height, f32 dt
+            tick    u16 flags, then f32 x, y if REPLAY_FLAG_DRAG, f32 width, height if REPLAY_FLAG_SIZE,
+                    f32 dt if REPLAY_FLAG_DT
+            end     u16 REPLAY_FLAG_END, u32 ticks, u32 world_checksum of the last tick
+        The field size and the tick length are only written when they change, a tick of plain input is 2 bytes.
+        The checksum covers the whole simulation state, so it lets the player prove that it simulated the same game.
+*/
+
+#define REPLAY_VERSION 2 /* 2: world_checksum covers the whole simulation state */
+
+/* Bits of the u16 in front of every tick */
+#define REPLAY_FLAG_ROTATE_LEFT (1u << 0)
+#define REPLAY_FLAG_ROTATE_RIGHT (1u << 1)
+#define REPLAY_FLAG_THRUST (1u << 2)
+#define REPLAY_FLAG_BRAKE (1u << 3)
+#define REPLAY_FLAG_SHOOT (1u << 4)
+#define REPLAY_FLAG_DRAG (1u << 5)
+#define REPLAY_FLAG_PAUSED (1u << 6)
+#define REPLAY_FLAG_SIZE (1u << 7) /* the field was resized before this tick */
+#define REPLAY_FLAG_DT (1u << 8)   /* the tick length differs from the last tick */
+#define REPLAY_FLAG_END (1u << 15) /* no more ticks, the trailer follows */
+
+/* Everything needed to create the world before the first tick */
+typedef struct
+{
+    unsigned int seed;
+    unsigned int asteroids; /* big asteroids added by world_add_asteroids after world_new */
+    Vector2 size;
+    float dt;
+} ReplayHeader;
+
+typedef struct
+{
+    FILE *file;
+    bool recording;
+    ReplayHeader header;
+    int ticks;    /* written or read so far */
+    Vector2 size; /* field size and tick length of the last tick */
+    float dt;
+    bool finished;         /* the player read the end marker */
+    unsigned int checksum; /* read from the end marker */
+} Replay;
+
+/**
+ * @brief Creates a log and writes its header.
+ *
+ * @param path File to write.
+ * @param header Seed, field size and tick length the world is created with.
+ * @return Replay* NULL if the file cannot be created.
+ */
+Replay *replay_record_open(const char *path, const ReplayHeader *header);
+
+/**
+ * @brief Appends one tick, call with the same values that are passed to world_step.
+ *
+ * @param replay Log opened with replay_record_open.
+ * @param dt Length of the tick.
+ * @param size Field size during the tick.
+ * @param inputs Inputs of the tick.
+ */
+void replay_record_tick(Replay *replay, float dt, Vector2 size, const WorldInputs *inputs);
+
+/**
+ * @brief Opens a log for playback and reads its header.
+ *
+ * @param path File to read.
+ * @return Replay* NULL if the file cannot be read or is not a log of this version.
+ */
+Replay *replay_play_open(const char *path);
+
+/**
+ * @brief Creates the world a log starts from, world_new and world_add_asteroids with the header values.
+ *
+ * @param replay Opened log.
+ * @param thread_count Workers of the narrow phase, the result does not depend on it.
+ * @return World*
+ */
+World *replay_world_new(const Replay *replay, int thread_count);
+
+/**
+ * @brief Reads the next tick.
+ *
+ * @param replay Log opened with replay_play_open.
+ * @param dt Set to the length of the tick.
+ * @param size Set to the field size during the tick.
+ * @param inputs Set to the inputs of the tick.
+ * @return true if a tick was read, false at the end of the log or if it is truncated.
+ */
+bool replay_play_tick(Replay *replay, float *dt, Vector2 *size, WorldInputs *inputs);
+
+/**
+ * @brief Finishes a log and frees it.
+ *
+ * @param replay Log to close.
+ * @param world World after the last tick.
+ * @return true if a recording was written completely, or if a playback reached the end marker
+ * and world has the recorded checksum.
+ */
+bool replay_close(Replay *replay, const World *world);
+
+#endif
@@ -0,0 +1,61 @@
+#include <raylib.h>
+#include <raymath.h>
+#include <math.h>
+#include <float.h>
+#include "shape.h"
+
+static const ShapePrototype shape_prototypes[SHAPE_COUNT] = {
+    [SHAPE_SHIP_HITSHAPE] = {{{-10, -2}, {10, -2}, {0, 18}}, 3, {0, 0}},
+    [SHAPE_SHIP_BODY] = {{{-10, -2}, {0, 2}, {10, -2}, {0, 18}}, 4, {0, 0}},
+    [SHAPE_SHIP_TRAIL] = {{{-5, 2}, {5, 2}, {0, -6}}, 3, {0, 0}},
+    [SHAPE_PROJECTILE] = {{{-PROJECTILE_RADIUS, -PROJECTILE_RADIUS}, {PROJECTILE_RADIUS, -PROJECTILE_RADIUS}, {PROJECTILE_RADIUS, PROJECTILE_RADIUS}, {-PROJECTILE_RADIUS, PROJECTILE_RADIUS}}, 4, {0, 0}},
+};
+
+const ShapePrototype *shape_prototype(ShapeId id)
+{
+    return &shape_prototypes[id];
+}
+
+void asteroid_shape_finish(AsteroidShape *shape)
+{
+    Vector2 min = {FLT_MAX, FLT_MAX};
+    Vector2 max = {-FLT_MAX, -FLT_MAX};
+    float area = 0, cx = 0, cy = 0, second_moment = 0;
+    int i;
+    for (i = 0; i < ASTEROID_POINTS; i++)
+    {
+        Vector2 a = shape->outline[i];
+        Vector2 b = shape->outline[(i + 1) % ASTEROID_POINTS];
+        float cross = a.x * b.y - b.x * a.y;
+        min = Vector2Min(min, a);
+        max = Vector2Max(max, a);
+        area += cross;
+        cx += (a.x + b.x) * cross;
+        cy += (a.y + b.y) * cross;
+        second_moment += (a.x * a.x + a.x * b.x + b.x * b.x + a.y * a.y + a.y * b.y + b.y * b.y) * cross;
+    }
+    area *= 0.5f;
+    shape->min = min;
+    shape->max = max;
+    shape->hitshape[0] = (Vector2){min.x, min.y};
+    shape->hitshape[1] = (Vector2){max.x, min.y};
+    shape->hitshape[2] = (Vector2){max.x, max.y};
+    shape->hitshape[3] = (Vector2){min.x, max.y};
+    shape->center = (Vector2){(max.x - min.x) / 2, (max.y - min.y) / 2};
+    shape->bounding_radius = 0;
+    for (i = 0; i < ASTEROID_HITSHAPE_POINTS; i++)
+    {
+        shape->bounding_radius = fmaxf(shape->bounding_radius, Vector2Length(shape->hitshape[i]));
+    }
+    shape->area = fabsf(area);
+    if (area != 0)
+    {
+        /* Second moment around the origin, moved to the centroid with the parallel axis theorem */
+        Vector2 centroid = {cx / (6 * area), cy / (6 * area)};
+        shape->inertia = fabsf(second_moment / 12) - shape->area * Vector2LengthSqr(centroid);
+    }
+    else
+    {
+        shape->inertia = 0;
+    }
+}
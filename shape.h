@@ -0,0 +1,80 @@
+/**
+ * @file shape.h
+ * @brief Shared, immutable local space shapes. Entities refer to a prototype by its ShapeId
+ * instead of owning a copy of its vertices.
+ *
+ */
+
+#ifndef SHAPE_H_
+#define SHAPE_H_
+
+#include <raylib.h>
+#include "collision.h"
+
+/*
+    INFO:
+        Prototypes are static const data, nothing is allocated to create, copy or destroy an entity
+        that uses one, so firing and expiring projectiles never touch the heap.
+        Asteroid outlines come from an AsteroidShapeBank. It is filled once when the world is created with
+        ASTEROID_SHAPES_PER_CLASS random outlines per asteroid size, together with everything derived
+        from them, so spawning an asteroid only picks an index into the bank.
+*/
+
+#define PROJECTILE_RADIUS 2
+#define ASTEROID_POINTS 11
+#define ASTEROID_HITSHAPE_POINTS 4
+/* Asteroid sizes, big, medium and small */
+#define ASTEROID_SHAPE_CLASSES 3
+#define ASTEROID_SHAPES_PER_CLASS 16
+
+typedef enum
+{
+    SHAPE_SHIP_HITSHAPE,
+    SHAPE_SHIP_BODY,
+    SHAPE_SHIP_TRAIL,
+    SHAPE_PROJECTILE,
+    SHAPE_COUNT,
+} ShapeId;
+
+typedef struct
+{
+    Vector2 points[SHAPE_MAX_POINTS]; /* local space, convex for the shapes used as hitshapes */
+    int num_points;
+    Vector2 center; /* offset of the shape center from the entity position */
+} ShapePrototype;
+
+/* Local space shape of an asteroid and the values derived from it, one entry of the shape bank */
+typedef struct
+{
+    Vector2 outline[ASTEROID_POINTS];
+    Vector2 hitshape[ASTEROID_HITSHAPE_POINTS]; /* bounding box of the outline */
+    Vector2 center;
+    Vector2 min; /* bounds of the outline */
+    Vector2 max;
+    float bounding_radius; /* distance of the farthest hitshape corner, bounds the shape at any rotation */
+    float area;            /* of the outline, for unit density this is also its mass */
+    float inertia;         /* moment of inertia of the outline around its centroid at unit density */
+} AsteroidShape;
+
+/* Shapes of class c are [c * ASTEROID_SHAPES_PER_CLASS, (c + 1) * ASTEROID_SHAPES_PER_CLASS) */
+typedef struct
+{
+    AsteroidShape shapes[ASTEROID_SHAPE_CLASSES * ASTEROID_SHAPES_PER_CLASS];
+} AsteroidShapeBank;
+
+/**
+ * @brief Computes the hitshape, center, bounds and mass properties of an asteroid from its outline.
+ *
+ * @param shape Shape with outline filled in.
+ */
+void asteroid_shape_finish(AsteroidShape *shape);
+
+/**
+ * @brief Returns the prototype of a shape.
+ *
+ * @param id Shape to look up.
+ * @return const ShapePrototype*
+ */
+const ShapePrototype *shape_prototype(ShapeId id);
+
+#endif
@@ -0,0 +1,294 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "snapshot.h"
+
+static const char snapshot_magic[8] = "ASTSNAP";
+
+static void *snapshot_calloc(size_t count, size_t size)
+{
+    void *ptr = calloc(count, size);
+    if (!ptr)
+    {
+        fprintf(stderr, "Failed to allocate memory for snapshot\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+/* Bytes per asteroid of a store column, 0 for the sections that are not columns */
+static size_t snapshot_column_size(SnapshotSectionId id)
+{
+    switch (id)
+    {
+    case SNAPSHOT_POSITION:
+    case SNAPSHOT_VELOCITY:
+    case SNAPSHOT_PREVIOUS_POSITION:
+        return sizeof(Vector2);
+    case SNAPSHOT_ANGULAR_VELOCITY:
+    case SNAPSHOT_ROTATION:
+    case SNAPSHOT_PREVIOUS_ROTATION:
+    case SNAPSHOT_RADIUS:
+        return sizeof(float);
+    case SNAPSHOT_HEALTH:
+    case SNAPSHOT_SHAPE:
+        return sizeof(int);
+    case SNAPSHOT_ID:
+        return sizeof(unsigned int);
+    case SNAPSHOT_COLOR:
+        return sizeof(Color);
+    default:
+        return 0;
+    }
+}
+
+/* Size a section must have for the counts in the header */
+static unsigned long long snapshot_section_size(SnapshotSectionId id, int asteroid_count, int projectile_count)
+{
+    if (id == SNAPSHOT_SHAPES)
+    {
+        return sizeof(AsteroidShapeBank);
+    }
+    if (id == SNAPSHOT_PROJECTILES)
+    {
+        return (unsigned long long)projectile_count * sizeof(Projectile);
+    }
+    return (unsigned long long)asteroid_count * snapshot_column_size(id);
+}
+
+/* Array of the store or world a section holds */
+static void *snapshot_world_array(const World *world, SnapshotSectionId id)
+{
+    AsteroidStore *store = world->asteroids;
+    switch (id)
+    {
+    case SNAPSHOT_SHAPES:
+        return (void *)&world->asteroid_shapes;
+    case SNAPSHOT_POSITION:
+        return store->position;
+    case SNAPSHOT_VELOCITY:
+        return store->velocity;
+    case SNAPSHOT_ANGULAR_VELOCITY:
+        return store->angular_velocity;
+    case SNAPSHOT_ROTATION:
+        return store->rotation;
+    case SNAPSHOT_PREVIOUS_POSITION:
+        return store->previous_position;
+    case SNAPSHOT_PREVIOUS_ROTATION:
+        return store->previous_rotation;
+    case SNAPSHOT_HEALTH:
+        return store->health;
+    case SNAPSHOT_RADIUS:
+        return store->radius;
+    case SNAPSHOT_SHAPE:
+        return store->shape;
+    case SNAPSHOT_ID:
+        return store->id;
+    case SNAPSHOT_COLOR:
+        return store->color;
+    case SNAPSHOT_PROJECTILES:
+        return projectile_vec_data(world->projectile_vec);
+    default:
+        return NULL;
+    }
+}
+
+static unsigned long long snapshot_align(unsigned long long offset)
+{
+    return (offset + SNAPSHOT_ALIGNMENT - 1) & ~(unsigned long long)(SNAPSHOT_ALIGNMENT - 1);
+}
+
+bool snapshot_save(const World *world, const char *path)
+{
+    static const unsigned char padding[SNAPSHOT_ALIGNMENT];
+    SnapshotHeader *header = (SnapshotHeader *)snapshot_calloc(1, sizeof(SnapshotHeader));
+    memcpy(header->magic, snapshot_magic, sizeof(header->magic));
+    header->version = SNAPSHOT_VERSION;
+    header->byte_order = SNAPSHOT_BYTE_ORDER;
+    header->header_size = sizeof(SnapshotHeader);
+    header->ship_size = sizeof(Ship);
+    header->projectile_size = sizeof(Projectile);
+    header->shape_size = sizeof(AsteroidShape);
+    header->asteroid_count = world->asteroids->count;
+    header->projectile_count = (int)projectile_vec_size(world->projectile_vec);
+    header->next_id = world->asteroids->next_id;
+    header->rng_state = world->rng_state;
+    header->size = world->size;
+    header->time = world->time;
+    header->ship = world->ship;
+    unsigned long long offset = sizeof(SnapshotHeader);
+    int i;
+    for (i = 0; i < SNAPSHOT_SECTION_COUNT; i++)
+    {
+        offset = snapshot_align(offset);
+        header->sections[i].offset = offset;
+        header->sections[i].size = snapshot_section_size((SnapshotSectionId)i, header->asteroid_count, header->projectile_count);
+        offset += header->sections[i].size;
+    }
+    FILE *file = fopen(path, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "Failed to open %s for the snapshot\n", path);
+        free(header);
+        return false;
+    }
+    fwrite(header, sizeof(SnapshotHeader), 1, file);
+    offset = sizeof(SnapshotHeader);
+    for (i = 0; i < SNAPSHOT_SECTION_COUNT; i++)
+    {
+        SnapshotSection *section = &header->sections[i];
+        fwrite(padding, 1, (size_t)(section->offset - offset), file);
+        if (section->size > 0)
+        {
+            fwrite(snapshot_world_array(world, (SnapshotSectionId)i), 1, (size_t)section->size, file);
+        }
+        offset = section->offset + section->size;
+    }
+    bool ok = !ferror(file);
+    ok = fclose(file) == 0 && ok;
+    free(header);
+    return ok;
+}
+
+static bool snapshot_shape_id_valid(ShapeId id)
+{
+    return (int)id >= 0 && (int)id < SHAPE_COUNT;
+}
+
+/* Every index a loaded world looks up another array with, the sections must already be known to fit the file */
+static bool snapshot_indices_valid(const SnapshotHeader *header)
+{
+    const unsigned char *base = (const unsigned char *)header;
+    const int *shapes = (const int *)(base + header->sections[SNAPSHOT_SHAPE].offset);
+    const Projectile *projectiles = (const Projectile *)(base + header->sections[SNAPSHOT_PROJECTILES].offset);
+    int i;
+    for (i = 0; i < header->asteroid_count; i++)
+    {
+        if (shapes[i] < 0 || shapes[i] >= ASTEROID_SHAPE_CLASSES * ASTEROID_SHAPES_PER_CLASS)
+        {
+            return false;
+        }
+    }
+    if (!snapshot_shape_id_valid(header->ship.entity.hitshape.shape))
+    {
+        return false;
+    }
+    for (i = 0; i < header->projectile_count; i++)
+    {
+        if (!snapshot_shape_id_valid(projectiles[i].entity.hitshape.shape))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+    Layout, sizes and every index snapshot_load copies, so a bad file is rejected before anything reads
+    past a section or indexes out of bounds with it. Float values, the shape outlines among them, are
+    taken as they are.
+*/
+static bool snapshot_valid(const SnapshotHeader *header, size_t file_size)
+{
+    int i;
+    if (file_size < sizeof(SnapshotHeader) || memcmp(header->magic, snapshot_magic, sizeof(snapshot_magic)) != 0)
+    {
+        return false;
+    }
+    if (header->version != SNAPSHOT_VERSION || header->byte_order != SNAPSHOT_BYTE_ORDER || header->header_size != sizeof(SnapshotHeader) ||
+        header->ship_size != sizeof(Ship) || header->projectile_size != sizeof(Projectile) || header->shape_size != sizeof(AsteroidShape))
+    {
+        return false;
+    }
+    if (header->asteroid_count < 0 || header->projectile_count < 0)
+    {
+        return false;
+    }
+    for (i = 0; i < SNAPSHOT_SECTION_COUNT; i++)
+    {
+        const SnapshotSection *section = &header->sections[i];
+        if (section->offset % SNAPSHOT_ALIGNMENT != 0 || section->offset > file_size || section->size > file_size - section->offset)
+        {
+            return false;
+        }
+        if (section->size != snapshot_section_size((SnapshotSectionId)i, header->asteroid_count, header->projectile_count))
+        {
+            return false;
+        }
+    }
+    return snapshot_indices_valid(header);
+}
+
+Snapshot *snapshot_open(const char *path)
+{
+    FileMap *map = file_map_open(path);
+    if (!map)
+    {
+        fprintf(stderr, "Failed to map %s for the snapshot\n", path);
+        return NULL;
+    }
+    const SnapshotHeader *header = (const SnapshotHeader *)file_map_data(map);
+    if (!snapshot_valid(header, file_map_size(map)))
+    {
+        fprintf(stderr, "%s is not a snapshot of version %d written by this build\n", path, SNAPSHOT_VERSION);
+        file_map_close(map);
+        return NULL;
+    }
+    Snapshot *snapshot = (Snapshot *)snapshot_calloc(1, sizeof(Snapshot));
+    snapshot->map = map;
+    snapshot->header = header;
+    return snapshot;
+}
+
+void snapshot_close(Snapshot *snapshot)
+{
+    if (!snapshot)
+        return;
+    file_map_close(snapshot->map);
+    free(snapshot);
+}
+
+const void *snapshot_section(const Snapshot *snapshot, SnapshotSectionId id, size_t *size)
+{
+    const SnapshotSection *section = &snapshot->header->sections[id];
+    if (size)
+    {
+        *size = (size_t)section->size;
+    }
+    return (const unsigned char *)snapshot->header + section->offset;
+}
+
+World *snapshot_load(const Snapshot *snapshot, int thread_count)
+{
+    const SnapshotHeader *header = snapshot->header;
+    int capacity = header->asteroid_count > ASTEROID_STORE_CAPACITY ? header->asteroid_count : ASTEROID_STORE_CAPACITY;
+    World *world = world_new_empty(header->size, header->rng_state, thread_count, capacity);
+    AsteroidStore *store = world->asteroids;
+    int i;
+    for (i = 0; i < SNAPSHOT_SECTION_COUNT; i++)
+    {
+        size_t size;
+        const void *data = snapshot_section(snapshot, (SnapshotSectionId)i, &size);
+        if (i != SNAPSHOT_PROJECTILES && size > 0)
+        {
+            memcpy(snapshot_world_array(world, (SnapshotSectionId)i), data, size);
+        }
+    }
+    store->count = header->asteroid_count;
+    store->next_id = header->next_id;
+    world->rng_state = header->rng_state;
+    world->time = header->time;
+    world->ship = header->ship;
+    world->ship.entity.proxy = AABB_TREE_NULL;
+    /* world_refit inserts every asteroid and computes its world space shape at the start of the next step */
+    for (i = 0; i < store->count; i++)
+    {
+        store->proxy[i] = AABB_TREE_NULL;
+    }
+    vec_push_back_n(world->projectile_vec, snapshot_section(snapshot, SNAPSHOT_PROJECTILES, NULL), (size_t)header->projectile_count);
+    for (i = 0; i < header->projectile_count; i++)
+    {
+        projectile_vec_at(world->projectile_vec, i)->entity.proxy = AABB_TREE_NULL;
+    }
+    return world;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file snapshot.h
+ * @brief Binary world snapshots that are loaded by mapping the file, without parsing.
+ *
+ */
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <raylib.h>
+#include "world.h"
+#include "file_map.h"
+
+/*
+    INFO:
+        A snapshot is a SnapshotHeader followed by one section per stored array. Sections hold the arrays
+        exactly as they are in memory, every AsteroidStore column, the projectile Vec and the shape bank,
+        each starting at a multiple of SNAPSHOT_ALIGNMENT. Sections are addressed by their offset from the
+        start of the file, so the file is valid at any address. snapshot_open checks the header and every
+        shape index, the asteroid shapes and the ship and projectile ShapeIds, then returns pointers into
+        the mapping.
+        Loading a world copies every section into the new world with one memcpy, nothing is allocated or
+        parsed per asteroid. World space shapes, broad-phase leaves, the axis cache and other per step state
+        are not stored, the first world_step rebuilds them.
+        The layout is the native one of the build that wrote the file. The header records the byte order
+        and the size of every stored struct, a build where any of them differ rejects the file.
+*/
+
+#define SNAPSHOT_VERSION 1
+/* Sections start at multiples of this, enough for any stored type and for SIMD loads */
+#define SNAPSHOT_ALIGNMENT 64
+/* Written as a native unsigned int, reads differently on a machine of the other byte order */
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+typedef enum
+{
+    SNAPSHOT_SHAPES, /* AsteroidShapeBank */
+    SNAPSHOT_POSITION,
+    SNAPSHOT_VELOCITY,
+    SNAPSHOT_ANGULAR_VELOCITY,
+    SNAPSHOT_ROTATION,
+    SNAPSHOT_PREVIOUS_POSITION,
+    SNAPSHOT_PREVIOUS_ROTATION,
+    SNAPSHOT_HEALTH,
+    SNAPSHOT_RADIUS,
+    SNAPSHOT_SHAPE,
+    SNAPSHOT_ID,
+    SNAPSHOT_COLOR,
+    SNAPSHOT_PROJECTILES, /* Projectile array */
+    SNAPSHOT_SECTION_COUNT,
+} SnapshotSectionId;
+
+typedef struct
+{
+    unsigned long long offset; /* from the start of the file */
+    unsigned long long size;   /* in bytes */
+} SnapshotSection;
+
+typedef struct
+{
+    char magic[8]; /* "ASTSNAP" */
+    unsigned int version;
+    unsigned int byte_order; /* SNAPSHOT_BYTE_ORDER */
+    /* sizeof of the stored structs in the build that wrote the file */
+    unsigned int header_size;
+    unsigned int ship_size;
+    unsigned int projectile_size;
+    unsigned int shape_size;
+    int asteroid_count;
+    int projectile_count;
+    unsigned int next_id; /* of the asteroid store */
+    unsigned int rng_state;
+    Vector2 size;
+    double time;
+    Ship ship;
+    SnapshotSection sections[SNAPSHOT_SECTION_COUNT];
+} SnapshotHeader;
+
+/* Mapped snapshot, every pointer points into the mapping */
+typedef struct
+{
+    FileMap *map;
+    const SnapshotHeader *header;
+} Snapshot;
+
+/**
+ * @brief Writes the state of a world to a snapshot.
+ *
+ * @param world World to save, between two steps.
+ * @param path File to write.
+ * @return true if the file was written.
+ */
+bool snapshot_save(const World *world, const char *path);
+
+/**
+ * @brief Maps a snapshot and checks its header and section bounds.
+ *
+ * @param path File to map.
+ * @return Snapshot* NULL if the file cannot be mapped or was written by an incompatible build.
+ */
+Snapshot *snapshot_open(const char *path);
+
+/**
+ * @brief Unmaps a snapshot, worlds loaded from it stay valid.
+ *
+ * @param snapshot Snapshot to close.
+ */
+void snapshot_close(Snapshot *snapshot);
+
+/**
+ * @brief Returns a section of the mapped file.
+ *
+ * @param snapshot Open snapshot.
+ * @param id Section to return.
+ * @param size Set to the size of the section in bytes. Can be NULL.
+ * @return const void* First byte of the section, aligned to SNAPSHOT_ALIGNMENT.
+ */
+const void *snapshot_section(const Snapshot *snapshot, SnapshotSectionId id, size_t *size);
+
+/**
+ * @brief Creates a world from a snapshot.
+ *
+ * @param snapshot Open snapshot.
+ * @param thread_count Workers of the narrow phase, the result does not depend on it.
+ * @return World* Has room for at least ASTEROID_STORE_CAPACITY asteroids, more if the snapshot holds more.
+ */
+World *snapshot_load(const Snapshot *snapshot, int thread_count);
+
+#endif
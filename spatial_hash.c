@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "spatial_hash.h"
+
+static void *spatial_hash_realloc(void *ptr, size_t size)
+{
+    void *tmp = realloc(ptr, size);
+    if (!tmp)
+    {
+        fprintf(stderr, "Failed to allocate memory for spatial hash\n");
+        exit(1);
+    }
+    return tmp;
+}
+
+static size_t hash_cell(int cx, int cy, size_t bucket_count)
+{
+    /* bucket_count is always a power of two */
+    return ((size_t)((unsigned int)cx * 73856093u ^ (unsigned int)cy * 19349663u)) & (bucket_count - 1);
+}
+
+static int cell_coord(float value, float inv_cell_size)
+{
+    return (int)floorf(value * inv_cell_size);
+}
+
+SpatialHash *spatial_hash_new(float cell_size)
+{
+    SpatialHash *hash = (SpatialHash *)calloc(1, sizeof(SpatialHash));
+    if (!hash)
+    {
+        fprintf(stderr, "Failed to allocate memory for spatial hash\n");
+        exit(1);
+    }
+    hash->cell_size = cell_size;
+    hash->inv_cell_size = 1.0f / cell_size;
+    return hash;
+}
+
+void spatial_hash_free(SpatialHash *hash)
+{
+    if (!hash)
+        return;
+    free(hash->items);
+    free(hash->entries);
+    free(hash->sorted);
+    free(hash->bucket_start);
+    free(hash);
+}
+
+void spatial_hash_clear(SpatialHash *hash)
+{
+    hash->item_count = 0;
+    hash->entry_count = 0;
+}
+
+void spatial_hash_insert(SpatialHash *hash, int id, Vector2 min, Vector2 max)
+{
+    if (hash->item_count >= hash->item_capacity)
+    {
+        hash->item_capacity = hash->item_capacity ? hash->item_capacity * 2 : 64;
+        hash->items = (SpatialHashItem *)spatial_hash_realloc(hash->items, hash->item_capacity * sizeof(SpatialHashItem));
+    }
+    int item = (int)hash->item_count++;
+    hash->items[item] = (SpatialHashItem){id, min, max};
+
+    int x0 = cell_coord(min.x, hash->inv_cell_size), x1 = cell_coord(max.x, hash->inv_cell_size);
+    int y0 = cell_coord(min.y, hash->inv_cell_size), y1 = cell_coord(max.y, hash->inv_cell_size);
+    size_t needed = hash->entry_count + (size_t)(x1 - x0 + 1) * (size_t)(y1 - y0 + 1);
+    if (needed > hash->entry_capacity)
+    {
+        while (hash->entry_capacity < needed)
+            hash->entry_capacity = hash->entry_capacity ? hash->entry_capacity * 2 : 256;
+        hash->entries = (SpatialHashEntry *)spatial_hash_realloc(hash->entries, hash->entry_capacity * sizeof(SpatialHashEntry));
+        hash->sorted = (SpatialHashEntry *)spatial_hash_realloc(hash->sorted, hash->entry_capacity * sizeof(SpatialHashEntry));
+    }
+    int x, y;
+    for (y = y0; y <= y1; y++)
+    {
+        for (x = x0; x <= x1; x++)
+        {
+            hash->entries[hash->entry_count++] = (SpatialHashEntry){item, x, y};
+        }
+    }
+}
+
+/* Counting sort of the cell entries into hash buckets */
+static void spatial_hash_build(SpatialHash *hash)
+{
+    size_t bucket_count = SPATIAL_HASH_MIN_BUCKETS;
+    while (bucket_count < hash->entry_count * 2)
+        bucket_count *= 2;
+    if (bucket_count + 1 > hash->bucket_capacity)
+    {
+        hash->bucket_capacity = bucket_count + 1;
+        hash->bucket_start = (size_t *)spatial_hash_realloc(hash->bucket_start, hash->bucket_capacity * sizeof(size_t));
+    }
+    hash->bucket_count = bucket_count;
+    memset(hash->bucket_start, 0, (bucket_count + 1) * sizeof(size_t));
+
+    size_t i;
+    for (i = 0; i < hash->entry_count; i++)
+    {
+        hash->bucket_start[hash_cell(hash->entries[i].cx, hash->entries[i].cy, bucket_count) + 1]++;
+    }
+    for (i = 0; i < bucket_count; i++)
+    {
+        hash->bucket_start[i + 1] += hash->bucket_start[i];
+    }
+    /* bucket_start[b] is used as the write cursor for bucket b, then shifted back */
+    for (i = 0; i < hash->entry_count; i++)
+    {
+        size_t bucket = hash_cell(hash->entries[i].cx, hash->entries[i].cy, bucket_count);
+        hash->sorted[hash->bucket_start[bucket]++] = hash->entries[i];
+    }
+    for (i = bucket_count; i > 0; i--)
+    {
+        hash->bucket_start[i] = hash->bucket_start[i - 1];
+    }
+    hash->bucket_start[0] = 0;
+}
+
+void spatial_hash_query_pairs(SpatialHash *hash, Vec *pairs)
+{
+    if (!hash->entry_count)
+        return;
+    spatial_hash_build(hash);
+    size_t bucket;
+    for (bucket = 0; bucket < hash->bucket_count; bucket++)
+    {
+        size_t start = hash->bucket_start[bucket], end = hash->bucket_start[bucket + 1], s, t;
+        for (s = start; s < end; s++)
+        {
+            SpatialHashEntry ea = hash->sorted[s];
+            SpatialHashItem *a = &hash->items[ea.item];
+            for (t = s + 1; t < end; t++)
+            {
+                SpatialHashEntry eb = hash->sorted[t];
+                if (ea.cx != eb.cx || ea.cy != eb.cy)
+                {
+                    continue; /* different cells that landed in the same bucket */
+                }
+                SpatialHashItem *b = &hash->items[eb.item];
+                if (a->max.x < b->min.x || b->max.x < a->min.x || a->max.y < b->min.y || b->max.y < a->min.y)
+                {
+                    continue;
+                }
+                /* Only the cell owning the top left corner of the overlap reports the pair */
+                if (cell_coord(fmaxf(a->min.x, b->min.x), hash->inv_cell_size) != ea.cx ||
+                    cell_coord(fmaxf(a->min.y, b->min.y), hash->inv_cell_size) != ea.cy)
+                {
+                    continue;
+                }
+                SpatialHashPair pair = a->id < b->id ? (SpatialHashPair){a->id, b->id} : (SpatialHashPair){b->id, a->id};
+                spatial_hash_pair_vec_push_back(pairs, &pair);
+            }
+        }
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ * @file spatial_hash.h
+ * @brief Uniform grid broad-phase. Items are inserted with a world space AABB each tick,
+ * then every unique pair of items that share a cell and whose AABBs overlap is emitted once.
+ *
+ */
+
+#ifndef SPATIAL_HASH_H_
+#define SPATIAL_HASH_H_
+
+#include <raylib.h>
+#include "C-Collection-Vector/vector.h"
+#include "C-Collection-Vector/vector_typed.h"
+
+/*
+    INFO:
+        The grid is rebuilt every tick, spatial_hash_clear followed by one spatial_hash_insert per item.
+        Cells are hashed into a bucket table sized from the number of inserted cell entries,
+        so the cost of a rebuild and query is linear in the number of items as long as
+        the cell size is close to the size of the largest item.
+*/
+
+#define SPATIAL_HASH_MIN_BUCKETS 16
+
+/* Pair emitted by spatial_hash_query_pairs, a < b */
+typedef struct
+{
+    int a;
+    int b;
+} SpatialHashPair;
+
+VEC_DEFINE(SpatialHashPair, spatial_hash_pair)
+
+typedef struct
+{
+    int id;
+    Vector2 min;
+    Vector2 max;
+} SpatialHashItem;
+
+typedef struct
+{
+    int item; /* index into SpatialHash.items */
+    int cx, cy;
+} SpatialHashEntry;
+
+typedef struct
+{
+    float cell_size;
+    float inv_cell_size;
+    SpatialHashItem *items;
+    size_t item_count;
+    size_t item_capacity;
+    SpatialHashEntry *entries; /* one entry per item per overlapped cell */
+    SpatialHashEntry *sorted;  /* entries grouped by bucket */
+    size_t entry_count;
+    size_t entry_capacity;
+    size_t *bucket_start; /* bucket_count + 1 offsets into sorted */
+    size_t bucket_count;
+    size_t bucket_capacity;
+} SpatialHash;
+
+/**
+ * @brief Creates an empty grid.
+ *
+ * @param cell_size Width and height of a cell, should be about the size of the largest item.
+ * @return SpatialHash*
+ */
+SpatialHash *spatial_hash_new(float cell_size);
+
+/**
+ * @brief Frees the grid and all of its internal buffers.
+ *
+ * @param hash Grid to free.
+ */
+void spatial_hash_free(SpatialHash *hash);
+
+/**
+ * @brief Removes all items, keeps the allocated memory for the next tick.
+ *
+ * @param hash Grid to clear.
+ */
+void spatial_hash_clear(SpatialHash *hash);
+
+/**
+ * @brief Adds an item to every cell its AABB touches.
+ *
+ * @param hash Grid to insert into.
+ * @param id User id returned in the pairs, usually an index into the caller's entity array.
+ * @param min Top left corner of the item's world space AABB.
+ * @param max Bottom right corner of the item's world space AABB.
+ */
+void spatial_hash_insert(SpatialHash *hash, int id, Vector2 min, Vector2 max);
+
+/**
+ * @brief Pushes every unique pair of inserted items with overlapping AABBs into pairs.
+ *
+ * @param hash Grid to query.
+ * @param pairs Vec of SpatialHashPair, pairs are appended and it is not cleared.
+ *
+ * @details A pair that shares several cells is only reported by the cell holding the
+ * top left corner of the intersection of both AABBs, so no pair is emitted twice.
+ * Output order only depends on insertion order.
+ */
+void spatial_hash_query_pairs(SpatialHash *hash, Vec *pairs);
+
+#endif
@@ -0,0 +1,41 @@
+#include <math.h>
+#include "timestep.h"
+
+Timestep timestep_new(float tick_rate, int max_substeps)
+{
+    Timestep timestep;
+    timestep.dt = 1.0f / tick_rate;
+    timestep.max_substeps = max_substeps < 1 ? 1 : max_substeps;
+    timestep.accumulator = 0;
+    return timestep;
+}
+
+int timestep_advance(Timestep *timestep, float frame_time)
+{
+    if (frame_time > 0)
+    {
+        timestep->accumulator += frame_time;
+    }
+    int ticks = (int)(timestep->accumulator / timestep->dt);
+    if (ticks > timestep->max_substeps)
+    {
+        /* Drop the time that does not fit, only the fraction of a tick is kept for interpolation */
+        ticks = timestep->max_substeps;
+        timestep->accumulator = fmod(timestep->accumulator, timestep->dt);
+    }
+    else
+    {
+        timestep->accumulator -= ticks * (double)timestep->dt;
+    }
+    if (timestep->accumulator < 0)
+    {
+        timestep->accumulator = 0;
+    }
+    return ticks;
+}
+
+float timestep_alpha(const Timestep *timestep)
+{
+    float alpha = (float)(timestep->accumulator / timestep->dt);
+    return alpha < 1.0f ? alpha : 0.999999f;
+}
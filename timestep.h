@@ -0,0 +1,53 @@
+/**
+ * @file timestep.h
+ * @brief Fixed timestep accumulator. Turns variable frame times into a whole number of
+ * equally long simulation ticks plus an interpolation factor for rendering.
+ *
+ */
+
+#ifndef TIMESTEP_H_
+#define TIMESTEP_H_
+
+/*
+    INFO:
+        Every frame the frame time is added to the accumulator and whole ticks of dt are taken out of it.
+        At most max_substeps ticks run per frame, time beyond that is dropped so a long stall slows the
+        game down instead of making the next frames do ever more ticks.
+        What is left in the accumulator is a fraction of a tick, timestep_alpha returns it in [0, 1)
+        and the renderer uses it to blend between the previous and the current tick.
+*/
+
+typedef struct
+{
+    float dt;           /* length of one tick in seconds */
+    int max_substeps;   /* most ticks run for a single frame */
+    double accumulator; /* simulation time owed, less than dt after timestep_advance */
+} Timestep;
+
+/**
+ * @brief Creates an empty accumulator.
+ *
+ * @param tick_rate Ticks per second.
+ * @param max_substeps Most ticks run for a single frame, at least 1.
+ * @return Timestep
+ */
+Timestep timestep_new(float tick_rate, int max_substeps);
+
+/**
+ * @brief Adds the time of a frame and takes the ticks to run out of the accumulator.
+ *
+ * @param timestep Accumulator to advance.
+ * @param frame_time Time since the last frame in seconds.
+ * @return int Number of ticks of timestep->dt to run this frame, at most max_substeps.
+ */
+int timestep_advance(Timestep *timestep, float frame_time);
+
+/**
+ * @brief Returns how far the current frame is between the last two ticks.
+ *
+ * @param timestep Accumulator to query.
+ * @return float In [0, 1), 0 draws the previous tick and 1 would draw the last one.
+ */
+float timestep_alpha(const Timestep *timestep);
+
+#endif
@@ -0,0 +1,1081 @@
+#include <raylib.h>
+#include <raymath.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "world.h"
+#include "profiler.h"
+#include "world_query.h"
+#include "integrate.h"
+
+/* Pairs per job pool chunk in the asteroid vs asteroid narrow phase */
+#define WORLD_ASTEROID_PAIR_CHUNK 64
+/* Blocks of up to SAT_BATCH_LANES pairs per chunk in the ship/projectile vs asteroid narrow phase */
+#define WORLD_PLAYER_BLOCK_CHUNK 8
+/* Swept asteroid contacts never overlapped, the MTV only carries the normal */
+#define WORLD_SWEEP_CONTACT_DEPTH 0.001f
+
+/* Axis found for an asteroid pair by a worker, stored into the axis cache after the job */
+typedef struct
+{
+    unsigned int id0;
+    unsigned int id1;
+    Vector2 axis;
+} AxisUpdate;
+
+VEC_DEFINE(AxisUpdate, axis_update)
+
+/* Run of pairs with the same ship or projectile, tested with one sat_collision_batch call */
+typedef struct
+{
+    int begin;
+    int count;
+} PlayerBlock;
+
+VEC_DEFINE(PlayerBlock, player_block)
+
+static void *world_calloc(size_t count, size_t size)
+{
+    void *ptr = calloc(count, size);
+    if (!ptr)
+    {
+        fprintf(stderr, "Failed to allocate memory for world\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+int world_random_value(World *world, int min, int max)
+{
+    if (min > max)
+    {
+        int tmp = max;
+        max = min;
+        min = tmp;
+    }
+    /* xorshift32 */
+    unsigned int x = world->rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    world->rng_state = x;
+    return min + (int)(x % (unsigned int)(max - min + 1));
+}
+
+/* Caches the world space hitshape, called once per tick after the entity moved */
+static void entity_update_world_shape(EntityData *entity)
+{
+    const ShapePrototype *shape = shape_prototype(entity->hitshape.shape);
+    world_shape_update(&entity->hitshape.world, shape->points, shape->num_points, Vector2Add(entity->position, shape->center), entity->rotation);
+}
+
+/* Inserts a cached shape into the tree or refits its leaf, user is the owner's current index */
+static void shape_tree_move(AABBTree *tree, int *proxy, int user, WorldShape *world, Vector2 displacement)
+{
+    if (*proxy == AABB_TREE_NULL)
+    {
+        *proxy = aabb_tree_insert(tree, user, world->min, world->max, displacement);
+        return;
+    }
+    aabb_tree_set_user(tree, *proxy, user);
+    aabb_tree_move(tree, *proxy, world->min, world->max, displacement);
+}
+
+static void entity_tree_move(AABBTree *tree, EntityData *entity, int user, Vector2 displacement)
+{
+    shape_tree_move(tree, &entity->proxy, user, &entity->hitshape.world, displacement);
+}
+
+int return_to_screen(Vector2 *position, Vector2 size)
+{
+    int rc = 0;
+    if (position->x > size.x)
+    {
+        position->x = 0;
+        rc++;
+    }
+    if (position->x < 0)
+    {
+        position->x = size.x;
+        rc++;
+    }
+    if (position->y > size.y)
+    {
+        position->y = 0;
+        rc++;
+    }
+    if (position->y < 0)
+    {
+        position->y = size.y;
+        rc++;
+    }
+    return rc;
+}
+
+/* Index of the size class of an asteroid radius in the shape bank */
+static int asteroid_shape_class(float asteroid_radius)
+{
+    if (asteroid_radius == ASTEROID_RADIUS_BIG)
+    {
+        return 0;
+    }
+    if (asteroid_radius == ASTEROID_RADIUS_MEDIUM)
+    {
+        return 1;
+    }
+    return 2;
+}
+
+/* Generates every outline of the shape bank, called once by world_new */
+static void asteroid_shape_bank_fill(World *world)
+{
+    static const float radii[ASTEROID_SHAPE_CLASSES] = {ASTEROID_RADIUS_BIG, ASTEROID_RADIUS_MEDIUM, ASTEROID_RADIUS_SMALL};
+    int c, k, i;
+    for (c = 0; c < ASTEROID_SHAPE_CLASSES; c++)
+    {
+        for (k = 0; k < ASTEROID_SHAPES_PER_CLASS; k++)
+        {
+            AsteroidShape *shape = &world->asteroid_shapes.shapes[c * ASTEROID_SHAPES_PER_CLASS + k];
+            for (i = 0; i < ASTEROID_POINTS; i++)
+            {
+                float angle = (float)i / ASTEROID_POINTS * 2 * PI;                                                    // even distribution of points around the circle
+                float radius = radii[c] * 0.5 + ((float)world_random_value(world, 0, 50) / 100.0f) * radii[c]; // random radius variation
+                shape->outline[i] = (Vector2){
+                    cosf(angle) * radius,
+                    sinf(angle) * radius};
+            }
+            asteroid_shape_finish(shape);
+        }
+    }
+}
+
+int asteroid_spawn(World *world, float asteroid_radius, Vector2 pos, Vector2 vel)
+{
+    AsteroidStore *store = world->asteroids;
+    int index = asteroid_store_spawn(store);
+    if (index < 0)
+    {
+        fprintf(stderr, "Asteroid store is full, asteroid not spawned\n");
+        return -1;
+    }
+    store->radius[index] = asteroid_radius;
+    store->position[index] = pos;
+    store->previous_position[index] = pos;
+    store->velocity[index] = vel;
+    store->shape[index] = asteroid_shape_class(asteroid_radius) * ASTEROID_SHAPES_PER_CLASS + world_random_value(world, 0, ASTEROID_SHAPES_PER_CLASS - 1);
+    return index;
+}
+
+/* Caches the world space hitshape, called once per tick after the asteroid moved */
+static void asteroid_update_world_shape(AsteroidStore *store, int index)
+{
+    const AsteroidShape *shape = asteroid_store_shape(store, index);
+    world_shape_update(&store->world[index], shape->hitshape, ASTEROID_HITSHAPE_POINTS, Vector2Add(store->position[index], shape->center), store->rotation[index]);
+}
+
+void asteroid_update(World *world, float dt)
+{
+    AsteroidStore *store = world->asteroids;
+    size_t j;
+    integrate_wrap(store->position, store->velocity, store->rotation, store->angular_velocity, store->count, 100.0f * dt, dt, world->size,
+                   (Vector2){ASTEROID_MAX_VELOCITY, ASTEROID_MAX_VELOCITY}, world->wrapped_vec);
+    /* Random values are drawn in index order. The new velocity is within the clamp, so it does not matter that it comes after it. */
+    for (j = 0; j < int_vec_size(world->wrapped_vec); j++)
+    {
+        int i = *int_vec_at(world->wrapped_vec, j);
+        store->rotation[i] += world_random_value(world, 0, 360);
+        store->velocity[i] = (Vector2){world_random_value(world, -ASTEROID_MAX_VELOCITY, ASTEROID_MAX_VELOCITY), world_random_value(world, -ASTEROID_MAX_VELOCITY, ASTEROID_MAX_VELOCITY)};
+        if (Vector2Equals(store->velocity[i], Vector2Zero()))
+        {
+            store->velocity[i] = (Vector2){1, 1};
+        }
+    }
+}
+
+static void world_record(World *world, WorldCommandType type, int index)
+{
+    WorldCommand *command = world_command_vec_emplace_back(world->command_vec);
+    command->type = type;
+    command->index = index;
+}
+
+static void world_record_spawn(World *world, AsteroidSpawn spawn)
+{
+    WorldCommand *command = world_command_vec_emplace_back(world->command_vec);
+    command->type = WORLD_COMMAND_SPAWN_ASTEROID;
+    command->index = -1;
+    command->spawn = spawn;
+}
+
+/* Records the pieces of a destroyed asteroid, they are spawned later in the same commit */
+static void asteroid_split(World *world, int index)
+{
+    AsteroidStore *store = world->asteroids;
+    int i;
+    if (store->radius[index] == ASTEROID_RADIUS_BIG)
+    {
+        for (i = 0; i < 4; i++)
+        {
+            AsteroidSpawn medium = {ASTEROID_RADIUS_MEDIUM, store->position[index], (Vector2){world_random_value(world, -2, 2), world_random_value(world, -2, 2)}};
+            if (Vector2Equals(store->velocity[index], Vector2Zero()))
+            {
+                medium.velocity = (Vector2){1, 1};
+            }
+            world_record_spawn(world, medium);
+        }
+    }
+    else if (store->radius[index] == ASTEROID_RADIUS_MEDIUM)
+    {
+        AsteroidSpawn asteroid1 = {ASTEROID_RADIUS_SMALL, store->position[index], (Vector2){world_random_value(world, -2, 2), world_random_value(world, -2, 2)}};
+        AsteroidSpawn asteroid2 = {ASTEROID_RADIUS_SMALL, store->position[index], (Vector2){world_random_value(world, -2, 2), world_random_value(world, -2, 2)}};
+        world_record_spawn(world, asteroid1);
+        world_record_spawn(world, asteroid2);
+    }
+}
+
+/* 0 if eq, -1 if less, 1 if greater than, orders contacts by pair */
+static int contact_cmp(const void *data0, const void *data1)
+{
+    const Contact *contact0 = (const Contact *)data0;
+    const Contact *contact1 = (const Contact *)data1;
+    return (contact0->pair > contact1->pair) - (contact0->pair < contact1->pair);
+}
+
+static float Vector2CrossProduct(Vector2 a, Vector2 b)
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+void handle_asteroid_collision(AsteroidStore *store, int asteroid0, int asteroid1, Vector2 mtv)
+{
+    // Approximate the point of collision using the MTV
+    Vector2 pointOfImpact = Vector2Add(store->position[asteroid0], Vector2Scale(mtv, 0.5f));
+
+    // Calculate the relative velocity at the point of impact
+    Vector2 relativeVelocity = Vector2Subtract(store->velocity[asteroid0], store->velocity[asteroid1]);
+
+    // Calculate the normal of the collision using MTV
+    Vector2 collisionNormal = Vector2Normalize(mtv);
+
+    // Calculate the impulse
+    float relativeVelocityAlongNormal = Vector2DotProduct(relativeVelocity, collisionNormal);
+    float impulseMagnitude = (-(1 + 0.5f) * relativeVelocityAlongNormal) /
+        (1 / store->radius[asteroid0] + 1 / store->radius[asteroid1]); // assuming uniform density for simplicity
+
+    Vector2 impulse = Vector2Scale(collisionNormal, impulseMagnitude);
+
+    // Apply impulse to the linear velocities
+    store->velocity[asteroid0] = Vector2Add(store->velocity[asteroid0], Vector2Scale(impulse, 1 / store->radius[asteroid0]));
+    store->velocity[asteroid1] = Vector2Subtract(store->velocity[asteroid1], Vector2Scale(impulse, 1 / store->radius[asteroid1]));
+
+    // Calculate the torque (cross product of radius vector and impulse)
+    Vector2 radiusVector0 = Vector2Subtract(pointOfImpact, store->position[asteroid0]);
+    Vector2 radiusVector1 = Vector2Subtract(pointOfImpact, store->position[asteroid1]);
+    float torque0 = Vector2CrossProduct(radiusVector0, impulse);
+    float torque1 = Vector2CrossProduct(radiusVector1, impulse);
+
+    // Update angular velocities (assuming moment of inertia is proportional to radius squared)
+    store->angular_velocity[asteroid0] += torque0 / (store->radius[asteroid0] * store->radius[asteroid0]);
+    store->angular_velocity[asteroid1] -= torque1 / (store->radius[asteroid1] * store->radius[asteroid1]);
+
+    // Move the asteroids apart using the MTV to prevent overlap
+    store->position[asteroid0] = Vector2Add(store->position[asteroid0], Vector2Scale(mtv, 0.5f));
+    store->position[asteroid1] = Vector2Subtract(store->position[asteroid1], Vector2Scale(mtv, 0.5f));
+}
+
+Ship ship_new(Vector2 pos, Vector2 vel)
+{
+    Ship ship = {0};
+    ship.entity.velocity.linear = vel;
+    ship.entity.rotation = 0;
+    ship.entity.health = 100;
+    ship.entity.type = ET_SHIP;
+    ship.entity.proxy = AABB_TREE_NULL;
+    ship.state.draw_trail = false;
+    ship.state.is_immune = false;
+    ship.state.immune_duration = 2.0;
+    // ship.entity.hitbox = (Rectangle){ ship.entity.position.x, ship.entity.position.y, 20, 20 };
+    ship.entity.hitshape.shape = SHAPE_SHIP_HITSHAPE;
+    ship.entity.position = pos;
+    ship.entity.previous_position = pos;
+    ship.entity.previous_rotation = 0;
+    ship.entity.hitshape.color = BLUE;
+    return ship;
+}
+
+void ship_update(World *world, const WorldInputs *inputs, float dt)
+{
+    Ship *ship = &world->ship;
+    // Handling the rotation
+    if (inputs->rotate_left)
+    {
+        ship->entity.rotation -= 180 * dt; // Rotate left
+    }
+    if (inputs->rotate_right)
+    {
+        ship->entity.rotation += 180 * dt; // Rotate right
+    }
+
+    // Handling the movement
+    if (inputs->thrust)
+    {
+        Vector2 thrust = Vector2Rotate((Vector2){0, 1}, DEG2RAD * ship->entity.rotation);
+        thrust = Vector2Scale(thrust, 100.0f * dt);
+        ship->entity.velocity.linear = Vector2Add(ship->entity.velocity.linear, thrust);
+        ship->state.draw_trail = true;
+    }
+    else
+    {
+        ship->state.draw_trail = false;
+    }
+    if (inputs->brake)
+    {
+        ship->entity.velocity.linear = Vector2Lerp(ship->entity.velocity.linear, Vector2Zero(), 2.0f * dt);
+    }
+
+    // Updating the position
+    ship->entity.position = Vector2Add(ship->entity.position, Vector2Scale(ship->entity.velocity.linear, dt));
+    return_to_screen(&ship->entity.position, world->size);
+    if (ship->state.is_immune)
+    {
+        if (world->time - ship->state.last_hit_time > ship->state.immune_duration)
+        {
+            ship->state.is_immune = false;
+        }
+    }
+}
+
+void ship_on_hit(Ship *ship, double time)
+{
+    if (ship->state.is_immune)
+    {
+        return;
+    }
+    ship->state.is_immune = true;
+    ship->state.last_hit_time = time;
+    ship->entity.health -= 10;
+    if (ship->entity.health <= 0)
+    {
+        // Game over
+    }
+}
+
+Projectile projectile_new(float damage, Vector2 pos, Vector2 vel)
+{
+    Projectile projectile = {0};
+    projectile.damage = damage;
+    projectile.entity.position = pos;
+    projectile.entity.previous_position = pos;
+    projectile.entity.previous_rotation = 0;
+    projectile.entity.velocity.linear = vel;
+    projectile.entity.rotation = 0;
+    projectile.entity.type = ET_PROJECTILE;
+    projectile.entity.proxy = AABB_TREE_NULL;
+    projectile.entity.hitshape.shape = SHAPE_PROJECTILE;
+    projectile.entity.hitshape.color = WHITE;
+    return projectile;
+}
+
+void projectile_update(Projectile *projectile, float dt)
+{
+    projectile->entity.position = Vector2Add(projectile->entity.position, Vector2Scale(projectile->entity.velocity.linear, 100.0f * dt));
+}
+
+#define WORLD_FRAME_VEC_COUNT 8
+
+/* The Vecs backed by frame_arena */
+static void world_frame_vecs(World *world, Vec *frame_vecs[WORLD_FRAME_VEC_COUNT])
+{
+    frame_vecs[0] = world->asteroid_pair_vec;
+    frame_vecs[1] = world->player_pair_vec;
+    frame_vecs[2] = world->player_block_vec;
+    frame_vecs[3] = world->contact_vec;
+    frame_vecs[4] = world->command_vec;
+    frame_vecs[5] = world->query_vec;
+    frame_vecs[6] = world->drag_vec;
+    frame_vecs[7] = world->wrapped_vec;
+}
+
+World *world_new_empty(Vector2 size, unsigned int seed, int thread_count, int asteroid_capacity)
+{
+    World *world = (World *)world_calloc(1, sizeof(World));
+    world->size = size;
+    world->rng_state = seed ? seed : 0x9E3779B9u; /* xorshift never leaves 0 */
+    asteroid_shape_bank_fill(world);
+    world->asteroids = asteroid_store_new(asteroid_capacity, world->asteroid_shapes.shapes);
+    world->projectile_vec = projectile_vec_new(VECTOR_DEFAULT_CAP);
+    world->asteroid_grid = spatial_hash_new(ASTEROID_GRID_CELL_SIZE);
+    world->asteroid_pair_vec = spatial_hash_pair_vec_new(VECTOR_DEFAULT_CAP);
+    world->asteroid_tree = aabb_tree_new();
+    world->player_tree = aabb_tree_new();
+    world->player_pair_vec = vec_new(VECTOR_DEFAULT_CAP, sizeof(AABBTreePair), aabb_tree_pair_cmp, NULL, NULL);
+    world->player_block_vec = player_block_vec_new(VECTOR_DEFAULT_CAP);
+    world->job_pool = job_pool_new(thread_count);
+    int worker_count = job_pool_worker_count(world->job_pool);
+    int i;
+    world->worker_contact_vecs = (Vec **)world_calloc(worker_count, sizeof(Vec *));
+    world->worker_stats = (CollisionStats *)world_calloc(worker_count, sizeof(CollisionStats));
+    world->worker_axis_vecs = (Vec **)world_calloc(worker_count, sizeof(Vec *));
+    world->axis_cache = axis_cache_new(AXIS_CACHE_CAPACITY);
+    for (i = 0; i < worker_count; i++)
+    {
+        world->worker_contact_vecs[i] = contact_vec_new(VECTOR_DEFAULT_CAP);
+        world->worker_axis_vecs[i] = axis_update_vec_new(VECTOR_DEFAULT_CAP);
+    }
+    world->contact_vec = vec_new(VECTOR_DEFAULT_CAP, sizeof(Contact), contact_cmp, NULL, NULL);
+    world->command_vec = world_command_vec_new(VECTOR_DEFAULT_CAP);
+    world->query_vec = int_vec_new(VECTOR_DEFAULT_CAP);
+    world->drag_vec = int_vec_new(VECTOR_DEFAULT_CAP);
+    world->wrapped_vec = int_vec_new(VECTOR_DEFAULT_CAP);
+    world->asteroid_despawning = (unsigned char *)world_calloc(asteroid_capacity, sizeof(unsigned char));
+    world->frame_arena = arena_new(WORLD_FRAME_ARENA_SIZE);
+    VecAllocator frame_allocator = arena_vec_allocator(world->frame_arena);
+    Vec *frame_vecs[WORLD_FRAME_VEC_COUNT];
+    world_frame_vecs(world, frame_vecs);
+    for (i = 0; i < WORLD_FRAME_VEC_COUNT; i++)
+    {
+        vec_set_allocator(frame_vecs[i], &frame_allocator);
+    }
+
+    world->ship = ship_new((Vector2){500, 225}, (Vector2){500, 225});
+    world->ship.entity.velocity.linear = Vector2Zero();
+    world->ship.state.shot_cooldown = 1.0f / 15.0f;
+    return world;
+}
+
+World *world_new(Vector2 size, unsigned int seed, int thread_count)
+{
+    World *world = world_new_empty(size, seed, thread_count, ASTEROID_STORE_CAPACITY);
+    int i;
+    for (i = 0; i < 10; i++)
+    {
+        asteroid_spawn(world, ASTEROID_RADIUS_BIG, (Vector2){world_random_value(world, 0, size.x), world_random_value(world, 0, size.y)}, (Vector2){1, 1});
+    }
+    /* Testing collision */
+    asteroid_spawn(world, ASTEROID_RADIUS_BIG, (Vector2){size.x, size.y / 2}, (Vector2){-1, 0});
+    asteroid_spawn(world, ASTEROID_RADIUS_BIG, (Vector2){0, size.y / 2}, (Vector2){1, 0});
+    return world;
+}
+
+void world_free(World *world)
+{
+    if (!world)
+        return;
+    asteroid_store_free(world->asteroids);
+    vec_free(world->projectile_vec);
+    vec_free(world->asteroid_pair_vec);
+    spatial_hash_free(world->asteroid_grid);
+    vec_free(world->player_pair_vec);
+    vec_free(world->player_block_vec);
+    int i;
+    for (i = 0; i < job_pool_worker_count(world->job_pool); i++)
+    {
+        vec_free(world->worker_contact_vecs[i]);
+        vec_free(world->worker_axis_vecs[i]);
+    }
+    free(world->worker_contact_vecs);
+    free(world->worker_stats);
+    free(world->worker_axis_vecs);
+    axis_cache_free(world->axis_cache);
+    vec_free(world->contact_vec);
+    job_pool_free(world->job_pool);
+    vec_free(world->command_vec);
+    vec_free(world->query_vec);
+    vec_free(world->drag_vec);
+    vec_free(world->wrapped_vec);
+    free(world->asteroid_despawning);
+    arena_free(world->frame_arena);
+    aabb_tree_free(world->asteroid_tree);
+    aabb_tree_free(world->player_tree);
+    free(world);
+}
+
+void world_begin_frame(World *world)
+{
+    Vec *frame_vecs[WORLD_FRAME_VEC_COUNT];
+    size_t capacity[WORLD_FRAME_VEC_COUNT];
+    int i;
+    world_frame_vecs(world, frame_vecs);
+    for (i = 0; i < WORLD_FRAME_VEC_COUNT; i++)
+    {
+        capacity[i] = frame_vecs[i]->capacity;
+        vec_detach(frame_vecs[i]);
+    }
+    arena_reset(world->frame_arena);
+    for (i = 0; i < WORLD_FRAME_VEC_COUNT; i++)
+    {
+        vec_reserve(frame_vecs[i], capacity[i]);
+    }
+}
+
+static void world_shoot(World *world)
+{
+    Ship *ship = &world->ship;
+    if (world->time - ship->state.last_time_shot > ship->state.shot_cooldown)
+    {
+        ship->state.last_time_shot = world->time;
+        Projectile projectile = projectile_new(10, ship->entity.position, Vector2Rotate((Vector2){0, 3}, DEG2RAD * ship->entity.rotation));
+        projectile_vec_push_back(world->projectile_vec, &projectile);
+    }
+}
+
+/* vec_remove_if predicate, world_commit removes the leaf of every projectile with a despawn command */
+static int projectile_spent(const void *entry, void *context)
+{
+    (void)context;
+    return ((const Projectile *)entry)->entity.proxy == AABB_TREE_NULL;
+}
+
+/* Refit the broad-phase trees, the ship and projectiles share one tree and asteroids have their own */
+static void world_refit(World *world, float dt)
+{
+    AsteroidStore *store = world->asteroids;
+    Ship *ship = &world->ship;
+    int i;
+    size_t j;
+    ship->entity.hitshape.color = BLUE;
+    entity_update_world_shape(&ship->entity);
+    entity_tree_move(world->player_tree, &ship->entity, PLAYER_TREE_SHIP, Vector2Scale(ship->entity.velocity.linear, dt));
+    for (j = 0; j < projectile_vec_size(world->projectile_vec); j++)
+    {
+        Projectile *projectile = projectile_vec_at(world->projectile_vec, j);
+        entity_update_world_shape(&projectile->entity);
+        entity_tree_move(world->player_tree, &projectile->entity, (int)j, Vector2Scale(projectile->entity.velocity.linear, 100.0f * dt));
+    }
+    for (i = 0; i < store->count; i++)
+    {
+        store->color[i] = BLUE;
+        /* Added since the last step, world_refit_asteroids moved the others at its end */
+        if (store->proxy[i] == AABB_TREE_NULL)
+        {
+            asteroid_update_world_shape(store, i);
+            shape_tree_move(world->asteroid_tree, &store->proxy[i], i, &store->world[i], Vector2Scale(store->velocity[i], 100.0f * dt));
+        }
+    }
+}
+
+/* Moves every asteroid leaf to where the step left it, so queries between steps see the asteroids as they are */
+static void world_refit_asteroids(World *world, float dt)
+{
+    AsteroidStore *store = world->asteroids;
+    int i;
+    for (i = 0; i < store->count; i++)
+    {
+        asteroid_update_world_shape(store, i);
+        shape_tree_move(world->asteroid_tree, &store->proxy[i], i, &store->world[i], Vector2Scale(store->velocity[i], 100.0f * dt));
+    }
+}
+
+/* Moves the contacts of every worker into contact_vec in pair order, the order the pairs would be tested on one thread, and sums their stats */
+static void world_merge_contacts(World *world)
+{
+    int i;
+    size_t count = 0;
+    contact_vec_clear(world->contact_vec);
+    for (i = 0; i < job_pool_worker_count(world->job_pool); i++)
+    {
+        count += contact_vec_size(world->worker_contact_vecs[i]);
+    }
+    vec_reserve(world->contact_vec, count);
+    for (i = 0; i < job_pool_worker_count(world->job_pool); i++)
+    {
+        Vec *contacts = world->worker_contact_vecs[i];
+        vec_append(world->contact_vec, contacts);
+        contact_vec_clear(contacts);
+        collision_stats_add(&world->collision_stats, &world->worker_stats[i]);
+        memset(&world->worker_stats[i], 0, sizeof(CollisionStats));
+    }
+    /* Pairs are unique, so the order is the one contact_cmp gives */
+    vec_sort_by_key(world->contact_vec, offsetof(Contact, pair), VEC_KEY_INT32);
+}
+
+/* Narrow phase job over player_block_vec, only reads the world */
+static void world_player_blocks_job(void *context, int begin, int end, int worker)
+{
+    World *world = (World *)context;
+    AsteroidStore *store = world->asteroids;
+    Vec *contacts = world->worker_contact_vecs[worker];
+    CollisionStats *stats = &world->worker_stats[worker];
+    SatBatch batch;
+    int pair_of_lane[SAT_BATCH_LANES];
+    int i, lane;
+    for (i = begin; i < end; i++)
+    {
+        PlayerBlock *block = player_block_vec_at(world->player_block_vec, i);
+        int player = aabb_tree_pair_vec_at(world->player_pair_vec, block->begin)->a;
+        if (player != PLAYER_TREE_SHIP)
+        {
+            /* Projectiles are small and fast, they are swept over the tick instead of tested where they are */
+            EntityData *entity = &projectile_vec_at(world->projectile_vec, player)->entity;
+            Vector2 displacement = Vector2Scale(entity->velocity.linear, 100.0f * world->step_dt);
+            for (lane = 0; lane < block->count; lane++)
+            {
+                AABBTreePair *pair = aabb_tree_pair_vec_at(world->player_pair_vec, block->begin + lane);
+                Vector2 relative = Vector2Subtract(displacement, Vector2Scale(store->velocity[pair->b], 100.0f * world->step_dt));
+                SatSweep sweep;
+                if (sat_sweep_staged(&entity->hitshape.world, &store->world[pair->b], relative, &sweep, stats))
+                {
+                    Contact contact = {block->begin + lane, {0, 0}, sweep.toi};
+                    contact_vec_push_back(contacts, &contact);
+                }
+            }
+            continue;
+        }
+        EntityData *entity = &world->ship.entity;
+        sat_batch_clear(&batch);
+        for (lane = 0; lane < block->count; lane++)
+        {
+            AABBTreePair *pair = aabb_tree_pair_vec_at(world->player_pair_vec, block->begin + lane);
+            if (collision_bounds_overlap(&entity->hitshape.world, &store->world[pair->b], (Vector2){0, 0}, stats))
+            {
+                pair_of_lane[sat_batch_add(&batch, &store->world[pair->b])] = block->begin + lane;
+            }
+        }
+        if (batch.count == 0)
+        {
+            continue;
+        }
+        unsigned int hits = sat_collision_batch(&entity->hitshape.world, &batch, NULL);
+        for (lane = 0; lane < batch.count; lane++)
+        {
+            if (hits & (1u << lane))
+            {
+                Contact contact = {pair_of_lane[lane], {0, 0}, 0};
+                contact_vec_push_back(contacts, &contact);
+                stats->hits++;
+            }
+            else
+            {
+                stats->sat_rejects++;
+            }
+        }
+    }
+}
+
+/* Check ship and projectile collision with asteroid, only overlapping leaves are visited */
+static void world_collide_players(World *world)
+{
+    AsteroidStore *store = world->asteroids;
+    Vec *player_pair_vec = world->player_pair_vec;
+    int i;
+    size_t j;
+    PROFILE_BEGIN("broad_phase");
+    aabb_tree_pair_vec_clear(player_pair_vec);
+    aabb_tree_query_tree(world->player_tree, world->asteroid_tree, player_pair_vec);
+    /* Same order as aabb_tree_pair_cmp, the sort is stable so sorting by b first keeps it within each a */
+    vec_sort_by_key(player_pair_vec, offsetof(AABBTreePair, b), VEC_KEY_INT32);
+    vec_sort_by_key(player_pair_vec, offsetof(AABBTreePair, a), VEC_KEY_INT32); /* groups the candidate asteroids of each ship or projectile */
+    /* Split the candidates of every ship or projectile into blocks of SAT_BATCH_LANES */
+    player_block_vec_clear(world->player_block_vec);
+    PlayerBlock block = {0, 0};
+    for (j = 0; j < aabb_tree_pair_vec_size(player_pair_vec); j++)
+    {
+        int player = aabb_tree_pair_vec_at(player_pair_vec, j)->a;
+        if (block.count == SAT_BATCH_LANES || (block.count > 0 && aabb_tree_pair_vec_at(player_pair_vec, block.begin)->a != player))
+        {
+            player_block_vec_push_back(world->player_block_vec, &block);
+            block.begin = (int)j;
+            block.count = 0;
+        }
+        block.count++;
+    }
+    if (block.count > 0)
+    {
+        player_block_vec_push_back(world->player_block_vec, &block);
+    }
+    PROFILE_END();
+    PROFILE_BEGIN("narrow_phase");
+    job_pool_parallel_for(world->job_pool, (int)player_block_vec_size(world->player_block_vec), WORLD_PLAYER_BLOCK_CHUNK, world_player_blocks_job, world);
+    world_merge_contacts(world);
+    PROFILE_END();
+    PROFILE_BEGIN("resolve");
+    /* Resolve in pair order, hits with asteroids destroyed earlier in the tick are dropped */
+    int count = (int)contact_vec_size(world->contact_vec);
+    for (i = 0; i < count; i++)
+    {
+        Contact *contact = contact_vec_at(world->contact_vec, i);
+        AABBTreePair *pair = aabb_tree_pair_vec_at(player_pair_vec, contact->pair);
+        int asteroid = pair->b;
+        if (world->asteroid_despawning[asteroid])
+        {
+            continue;
+        }
+        if (pair->a == PLAYER_TREE_SHIP)
+        {
+            store->color[asteroid] = RED;
+            world->ship.entity.hitshape.color = RED;
+            continue;
+        }
+        Projectile *projectile = projectile_vec_at(world->projectile_vec, pair->a);
+        /* The contacts of a projectile are consecutive, it hits the living asteroid it reaches first */
+        float toi = contact->toi;
+        int j;
+        for (j = i + 1; j < count; j++)
+        {
+            Contact *next = contact_vec_at(world->contact_vec, j);
+            AABBTreePair *next_pair = aabb_tree_pair_vec_at(player_pair_vec, next->pair);
+            if (next_pair->a != pair->a)
+            {
+                break;
+            }
+            if (!world->asteroid_despawning[next_pair->b] && next->toi < toi)
+            {
+                toi = next->toi;
+                asteroid = next_pair->b;
+            }
+        }
+        i = j - 1;
+        world_record(world, WORLD_COMMAND_DESPAWN_PROJECTILE, pair->a);
+        store->health[asteroid] -= projectile->damage;
+        if (store->health[asteroid] <= 0)
+        {
+            world->asteroid_despawning[asteroid] = 1;
+            world_record(world, WORLD_COMMAND_DESPAWN_ASTEROID, asteroid);
+        }
+    }
+    PROFILE_END();
+}
+
+/* Applies the commands of the step, despawns first while the recorded indices are valid, then spawns */
+static void world_commit(World *world)
+{
+    AsteroidStore *store = world->asteroids;
+    int i;
+    size_t j;
+    /* Despawned entities are marked by removing their leaf, a projectile can be both hit and expired */
+    for (j = 0; j < world_command_vec_size(world->command_vec); j++)
+    {
+        WorldCommand *command = world_command_vec_at(world->command_vec, j);
+        int *proxy = NULL;
+        AABBTree *tree = NULL;
+        if (command->type == WORLD_COMMAND_DESPAWN_PROJECTILE)
+        {
+            proxy = &projectile_vec_at(world->projectile_vec, command->index)->entity.proxy;
+            tree = world->player_tree;
+        }
+        else if (command->type == WORLD_COMMAND_DESPAWN_ASTEROID)
+        {
+            world->asteroid_despawning[command->index] = 0;
+            proxy = &store->proxy[command->index];
+            tree = world->asteroid_tree;
+        }
+        if (proxy && *proxy != AABB_TREE_NULL)
+        {
+            aabb_tree_remove(tree, *proxy);
+            *proxy = AABB_TREE_NULL;
+        }
+    }
+    vec_remove_if(world->projectile_vec, projectile_spent, NULL);
+    /* Backwards, so despawning only moves asteroids that were already visited */
+    for (i = store->count - 1; i >= 0; i--)
+    {
+        if (store->proxy[i] == AABB_TREE_NULL)
+        {
+            PROFILE_BEGIN("asteroid_split");
+            asteroid_split(world, i);
+            PROFILE_END();
+            asteroid_store_despawn(store, i);
+            if (i < store->count && store->proxy[i] != AABB_TREE_NULL)
+            {
+                aabb_tree_set_user(world->asteroid_tree, store->proxy[i], i);
+            }
+        }
+    }
+    /* asteroid_split appended the spawn commands */
+    for (j = 0; j < world_command_vec_size(world->command_vec); j++)
+    {
+        WorldCommand *command = world_command_vec_at(world->command_vec, j);
+        if (command->type != WORLD_COMMAND_SPAWN_ASTEROID)
+        {
+            continue;
+        }
+        int index = asteroid_spawn(world, command->spawn.radius, command->spawn.position, command->spawn.velocity);
+        if (index >= 0)
+        {
+            asteroid_update_world_shape(store, index);
+        }
+    }
+    world_command_vec_clear(world->command_vec);
+}
+
+/* Narrow phase job over asteroid_pair_vec, only reads the world */
+static void world_asteroid_pairs_job(void *context, int begin, int end, int worker)
+{
+    World *world = (World *)context;
+    AsteroidStore *store = world->asteroids;
+    Vec *contacts = world->worker_contact_vecs[worker];
+    Vec *axis_updates = world->worker_axis_vecs[worker];
+    CollisionStats *stats = &world->worker_stats[worker];
+    int i;
+    for (i = begin; i < end; i++)
+    {
+        SpatialHashPair *pair = spatial_hash_pair_vec_at(world->asteroid_pair_vec, i);
+        WorldShape *shape0 = &store->world[pair->a];
+        WorldShape *shape1 = &store->world[pair->b];
+        Contact contact;
+        contact.pair = i;
+        contact.toi = 0;
+        /* Bounds are swept, so they reject only pairs that neither overlap now nor meet during the tick */
+        Vector2 relative = Vector2Scale(Vector2Subtract(store->velocity[pair->a], store->velocity[pair->b]), 100.0f * world->step_dt);
+        if (!collision_bounds_overlap(shape0, shape1, relative, stats))
+        {
+            continue;
+        }
+        AxisUpdate update = {store->id[pair->a], store->id[pair->b], {0, 0}};
+        if (axis_cache_find(world->axis_cache, update.id0, update.id1, &update.axis) && sat_axis_separates(shape0, shape1, update.axis, relative))
+        {
+            axis_update_vec_push_back(axis_updates, &update);
+            stats->sat_rejects++;
+            stats->cached_axis_rejects++;
+            continue;
+        }
+        bool hit = sat_collision_axis(shape0, shape1, &contact.mtv, &update.axis);
+        axis_update_vec_push_back(axis_updates, &update);
+        if (hit)
+        {
+            contact_vec_push_back(contacts, &contact);
+            stats->hits++;
+            continue;
+        }
+        /* Pairs that touch later in the tick are found by the next tick, unless they pass through each other before it */
+        SatSweep sweep;
+        if (!sat_axis_separates(shape0, shape1, update.axis, relative) && sat_sweep_cached(shape0, shape1, relative, &sweep) && sweep.exit < 1)
+        {
+            contact.mtv = Vector2Scale(sweep.normal, WORLD_SWEEP_CONTACT_DEPTH);
+            contact.toi = sweep.toi;
+            contact_vec_push_back(contacts, &contact);
+            stats->hits++;
+            continue;
+        }
+        stats->sat_rejects++;
+    }
+}
+
+/* Check asteroid collision with asteroid */
+static void world_collide_asteroids(World *world)
+{
+    AsteroidStore *store = world->asteroids;
+    int i;
+    size_t j;
+    PROFILE_BEGIN("broad_phase");
+    spatial_hash_clear(world->asteroid_grid);
+    for (i = 0; i < store->count; i++)
+    {
+        /* Swept bounds, so pairs that only meet during the tick are candidates too */
+        Vector2 displacement = Vector2Scale(store->velocity[i], 100.0f * world->step_dt);
+        Vector2 min = Vector2Min(store->world[i].min, Vector2Add(store->world[i].min, displacement));
+        Vector2 max = Vector2Max(store->world[i].max, Vector2Add(store->world[i].max, displacement));
+        spatial_hash_insert(world->asteroid_grid, i, min, max);
+    }
+    spatial_hash_pair_vec_clear(world->asteroid_pair_vec);
+    spatial_hash_query_pairs(world->asteroid_grid, world->asteroid_pair_vec);
+    PROFILE_END();
+    PROFILE_BEGIN("narrow_phase");
+    /* Workers read the axes of the last tick, the new ones are stored once they are done */
+    axis_cache_advance(world->axis_cache);
+    job_pool_parallel_for(world->job_pool, (int)spatial_hash_pair_vec_size(world->asteroid_pair_vec), WORLD_ASTEROID_PAIR_CHUNK, world_asteroid_pairs_job, world);
+    world_merge_contacts(world);
+    for (i = 0; i < job_pool_worker_count(world->job_pool); i++)
+    {
+        Vec *axis_updates = world->worker_axis_vecs[i];
+        size_t j;
+        for (j = 0; j < axis_update_vec_size(axis_updates); j++)
+        {
+            AxisUpdate *update = axis_update_vec_at(axis_updates, j);
+            axis_cache_store(world->axis_cache, update->id0, update->id1, update->axis);
+        }
+        axis_update_vec_clear(axis_updates);
+    }
+    PROFILE_END();
+    PROFILE_BEGIN("handle_asteroid_collision");
+    for (j = 0; j < contact_vec_size(world->contact_vec); j++)
+    {
+        Contact *contact = contact_vec_at(world->contact_vec, j);
+        SpatialHashPair *pair = spatial_hash_pair_vec_at(world->asteroid_pair_vec, contact->pair);
+        if (world->asteroid_despawning[pair->a] || world->asteroid_despawning[pair->b])
+        {
+            continue;
+        }
+        Vector2 center0 = Vector2Add(store->position[pair->a], asteroid_store_shape(store, pair->a)->center);
+        Vector2 center1 = Vector2Add(store->position[pair->b], asteroid_store_shape(store, pair->b)->center);
+        Vector2 mtv = contact->mtv;
+        /* Each pair is resolved once, so the MTV has to push asteroid0 away from asteroid1 */
+        if (Vector2DotProduct(mtv, Vector2Subtract(center0, center1)) < 0)
+        {
+            mtv = Vector2Negate(mtv);
+        }
+        handle_asteroid_collision(store, pair->a, pair->b, mtv);
+    }
+    PROFILE_END();
+}
+
+/* Drag asteroid with mouse, the tree still holds where the last step left the asteroids */
+static void world_drag(World *world, Vector2 drag_position)
+{
+    AsteroidStore *store = world->asteroids;
+    size_t j;
+    world_query_point_all(world, drag_position, world->drag_vec);
+    for (j = 0; j < int_vec_size(world->drag_vec); j++)
+    {
+        int i = *int_vec_at(world->drag_vec, j);
+        const AsteroidShape *shape = asteroid_store_shape(store, i);
+        Vector2 x = Vector2Subtract(drag_position, shape->center);
+        Vector2 old_pos = store->position[i];
+        store->position[i] = x;
+        Vector2 dx = Vector2Subtract(store->position[i], old_pos);
+        store->velocity[i] = Vector2Add(store->velocity[i], dx);
+    }
+}
+
+void world_add_asteroids(World *world, int count)
+{
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        /* Drawn one after the other, the order of evaluation inside an initializer is unspecified */
+        float x = (float)world_random_value(world, 0, (int)world->size.x);
+        float y = (float)world_random_value(world, 0, (int)world->size.y);
+        asteroid_spawn(world, ASTEROID_RADIUS_BIG, (Vector2){x, y}, (Vector2){1, 1});
+    }
+}
+
+/* FNV-1a step over size bytes */
+static unsigned int world_hash(unsigned int hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    size_t i;
+    for (i = 0; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/* Field by field, padding and the per tick caches (previous state, tree leaf, world shape, color) are left out */
+static unsigned int world_hash_entity(unsigned int hash, const EntityData *entity)
+{
+    hash = world_hash(hash, &entity->position, sizeof(entity->position));
+    hash = world_hash(hash, &entity->velocity.linear, sizeof(entity->velocity.linear));
+    hash = world_hash(hash, &entity->velocity.angular, sizeof(entity->velocity.angular));
+    hash = world_hash(hash, &entity->rotation, sizeof(entity->rotation));
+    hash = world_hash(hash, &entity->health, sizeof(entity->health));
+    hash = world_hash(hash, &entity->type, sizeof(entity->type));
+    return world_hash(hash, &entity->hitshape.shape, sizeof(entity->hitshape.shape));
+}
+
+unsigned int world_checksum(const World *world)
+{
+    const AsteroidStore *store = world->asteroids;
+    const Ship *ship = &world->ship;
+    unsigned int hash = 2166136261u;
+    size_t count = (size_t)store->count;
+    size_t i;
+    hash = world_hash(hash, &world->time, sizeof(world->time));
+    hash = world_hash(hash, &world->rng_state, sizeof(world->rng_state));
+    hash = world_hash(hash, &store->count, sizeof(store->count));
+    hash = world_hash(hash, &store->next_id, sizeof(store->next_id));
+    hash = world_hash(hash, store->position, count * sizeof(Vector2));
+    hash = world_hash(hash, store->velocity, count * sizeof(Vector2));
+    hash = world_hash(hash, store->angular_velocity, count * sizeof(float));
+    hash = world_hash(hash, store->rotation, count * sizeof(float));
+    hash = world_hash(hash, store->health, count * sizeof(int));
+    hash = world_hash(hash, store->radius, count * sizeof(float));
+    hash = world_hash(hash, store->shape, count * sizeof(int));
+    hash = world_hash(hash, store->id, count * sizeof(unsigned int));
+    hash = world_hash_entity(hash, &ship->entity);
+    hash = world_hash(hash, &ship->state.is_immune, sizeof(ship->state.is_immune));
+    hash = world_hash(hash, &ship->state.last_hit_time, sizeof(ship->state.last_hit_time));
+    hash = world_hash(hash, &ship->state.immune_duration, sizeof(ship->state.immune_duration));
+    hash = world_hash(hash, &ship->state.draw_trail, sizeof(ship->state.draw_trail));
+    hash = world_hash(hash, &ship->state.last_time_shot, sizeof(ship->state.last_time_shot));
+    hash = world_hash(hash, &ship->state.shot_cooldown, sizeof(ship->state.shot_cooldown));
+    /* Fixed width, so 32 and 64 bit builds agree */
+    unsigned int projectile_count = (unsigned int)projectile_vec_size(world->projectile_vec);
+    hash = world_hash(hash, &projectile_count, sizeof(projectile_count));
+    for (i = 0; i < projectile_count; i++)
+    {
+        const Projectile *projectile = projectile_vec_at(world->projectile_vec, i);
+        hash = world_hash(hash, &projectile->damage, sizeof(projectile->damage));
+        hash = world_hash_entity(hash, &projectile->entity);
+    }
+    return hash;
+}
+
+/* Records a despawn for every projectile that left the field, projectiles do not wrap around */
+static void world_expire_projectiles(World *world)
+{
+    size_t i;
+    for (i = 0; i < projectile_vec_size(world->projectile_vec); i++)
+    {
+        Vector2 position = projectile_vec_at(world->projectile_vec, i)->entity.position;
+        if (return_to_screen(&position, world->size))
+        {
+            world_record(world, WORLD_COMMAND_DESPAWN_PROJECTILE, (int)i);
+        }
+    }
+}
+
+/* Keeps the state at the start of the tick so the front end can draw between two ticks */
+static void world_save_previous(World *world)
+{
+    AsteroidStore *store = world->asteroids;
+    size_t i;
+    memcpy(store->previous_position, store->position, store->count * sizeof(Vector2));
+    memcpy(store->previous_rotation, store->rotation, store->count * sizeof(float));
+    world->ship.entity.previous_position = world->ship.entity.position;
+    world->ship.entity.previous_rotation = world->ship.entity.rotation;
+    for (i = 0; i < projectile_vec_size(world->projectile_vec); i++)
+    {
+        Projectile *projectile = projectile_vec_at(world->projectile_vec, i);
+        projectile->entity.previous_position = projectile->entity.position;
+        projectile->entity.previous_rotation = projectile->entity.rotation;
+    }
+}
+
+void world_step(World *world, float dt, const WorldInputs *inputs)
+{
+    size_t i;
+    PROFILE_BEGIN("world_step");
+    world->step_dt = inputs->paused ? 0 : dt;
+    memset(&world->collision_stats, 0, sizeof(CollisionStats));
+    world_save_previous(world);
+    if (inputs->shoot)
+    {
+        world_shoot(world);
+    }
+    PROFILE_BEGIN("refit");
+    world_refit(world, dt);
+    PROFILE_END();
+    PROFILE_BEGIN("collide_players");
+    world_collide_players(world);
+    PROFILE_END();
+    PROFILE_BEGIN("collide_asteroids");
+    world_collide_asteroids(world);
+    PROFILE_END();
+    if (inputs->drag)
+    {
+        world_drag(world, inputs->drag_position);
+    }
+    if (!inputs->paused)
+    {
+        PROFILE_BEGIN("update");
+        asteroid_update(world, dt);
+        for (i = 0; i < projectile_vec_size(world->projectile_vec); i++)
+        {
+            projectile_update(projectile_vec_at(world->projectile_vec, i), dt);
+        }
+        ship_update(world, inputs, dt);
+        PROFILE_END();
+    }
+    PROFILE_BEGIN("commit");
+    world_expire_projectiles(world);
+    world_commit(world);
+    PROFILE_END();
+    PROFILE_BEGIN("refit_asteroids");
+    world_refit_asteroids(world, dt);
+    PROFILE_END();
+    world->time += dt;
+    PROFILE_END();
+}
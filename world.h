@@ -0,0 +1,325 @@
+/**
+ * @file world.h
+ * @brief Headless simulation core. The world owns every entity and runs the update and
+ * collision passes, it never opens a window, reads the keyboard or draws.
+ *
+ */
+
+#ifndef WORLD_H_
+#define WORLD_H_
+
+#include <stdbool.h>
+#include <raylib.h>
+#include "C-Collection-Vector/vector.h"
+#include "C-Collection-Vector/vector_typed.h"
+#include "spatial_hash.h"
+#include "aabb_tree.h"
+#include "collision.h"
+#include "asteroid_store.h"
+#include "shape.h"
+#include "job_pool.h"
+#include "axis_cache.h"
+#include "arena.h"
+
+/*
+    INFO:
+        Only raylib's types and raymath are used here, no raylib function is called, so the core
+        runs on machines without a display. Everything the game used to ask the window for
+        (frame time, screen size, keys, mouse, time, random numbers) is either passed to world_step
+        or kept in the World. Random numbers come from the world's own generator, so two worlds
+        created with the same seed and stepped with the same inputs stay identical.
+        The front end reads the World after world_step to draw it.
+        Projectiles are tested with a swept SAT over the movement of the tick, a projectile hits the asteroid
+        it reaches first. Asteroid pairs that would pass completely through each other within one tick
+        are caught the same way, so the tick rate can be lowered without anything tunneling.
+        The narrow phase runs on the world's job pool. Workers only test pairs and write contacts into
+        their own Vec, the contacts are then sorted by pair index and resolved on the calling thread,
+        so the result is the same for any number of threads.
+        Nothing is added to or removed from the world during a step. Projectile hits, destroyed asteroids,
+        their split pieces and projectiles that left the field are recorded as WorldCommands and applied
+        together by the commit at the end of world_step, so indices stay valid for the whole step and
+        the passes only read the structure of the world. An asteroid destroyed in the step is skipped by
+        the rest of the step's collisions, its pieces collide from the next step on.
+        The asteroid tree is refit after the commit, so between steps it can be queried (world_query.h).
+        Pair, block, contact, command, query and wrap Vecs only hold data of the current step. Their memory comes from
+        frame_arena, which world_begin_frame resets once per frame, so a running world does not allocate
+        from the heap once its arena and Vecs have grown to the busiest frame. The per worker Vecs are
+        grown from worker threads and keep using the heap, they keep their capacity between steps.
+*/
+
+#define ASTEROID_HEALTH_START 100
+#define ASTEROID_HEALTH_END 0
+#define ASTEROID_ASTEROID_COLLIDE_HEALTH_STEP 10
+
+#define ASTEROID_RADIUS_BIG 32
+#define ASTEROID_RADIUS_MEDIUM 16
+#define ASTEROID_RADIUS_SMALL 8
+#define ASTEROID_MAX_VELOCITY 2 /* on each axis, in units per 1/100 s */
+#define ASTEROID_STORE_CAPACITY 4096
+#define ASTEROID_GRID_CELL_SIZE (ASTEROID_RADIUS_BIG * 2)
+/* Starting size of the frame arena in bytes, it grows to the busiest frame on its own */
+#define WORLD_FRAME_ARENA_SIZE (256 * 1024)
+/* Slots per table of the asteroid pair axis cache */
+#define AXIS_CACHE_CAPACITY 8192
+/* User id of the ship in the player tree, projectiles use their index in projectile_vec */
+#define PLAYER_TREE_SHIP (-1)
+
+typedef enum
+{
+    ET_ERROR,
+    ET_ASTEROID,
+    ET_SHIP,
+    ET_PROJECTILE,
+} EntityType;
+
+typedef struct
+{
+    Vector2 position;
+    Vector2 previous_position; /* position and rotation at the start of the last tick, for render interpolation */
+    float previous_rotation;
+    struct
+    {
+        Vector2 linear;
+        float angular;
+    } velocity;
+    float rotation;
+    int health;
+    EntityType type;
+    int proxy; /* leaf in the broad-phase tree, AABB_TREE_NULL if not inserted */
+    struct
+    {
+        ShapeId shape;    /* shared prototype, never owned by the entity */
+        WorldShape world; /* world space cache, refreshed once per tick */
+        Color color;      /* RED while touching an asteroid, used to draw the hitbox */
+    } hitshape;
+} EntityData;
+
+typedef struct
+{
+    EntityData entity;
+    struct
+    {
+        bool is_immune;
+        double last_hit_time;
+        float immune_duration;
+        bool draw_trail;
+        double last_time_shot;
+        float shot_cooldown;
+    } state;
+} Ship;
+
+typedef struct
+{
+    float damage;
+    EntityData entity;
+} Projectile;
+
+VEC_DEFINE(Projectile, projectile)
+
+/* Asteroid created by a split */
+typedef struct
+{
+    float radius;
+    Vector2 position;
+    Vector2 velocity;
+} AsteroidSpawn;
+
+typedef enum
+{
+    WORLD_COMMAND_SPAWN_ASTEROID,
+    WORLD_COMMAND_DESPAWN_ASTEROID, /* splits it on the commit */
+    WORLD_COMMAND_DESPAWN_PROJECTILE,
+} WorldCommandType;
+
+/* Structural change recorded during a step and applied by its commit */
+typedef struct
+{
+    WorldCommandType type;
+    int index;           /* of the asteroid or projectile, indices do not change before the commit */
+    AsteroidSpawn spawn; /* WORLD_COMMAND_SPAWN_ASTEROID */
+} WorldCommand;
+
+VEC_DEFINE(WorldCommand, world_command)
+
+/* Touching pair found by the narrow phase, pair is its index in the pair Vec that was tested */
+typedef struct
+{
+    int pair;
+    Vector2 mtv;
+    float toi; /* fraction of the tick at which the pair first touches, 0 if it overlapped at the start */
+} Contact;
+
+VEC_DEFINE(Contact, contact)
+
+/* Player input for one step, filled by the front end or by a script */
+typedef struct
+{
+    bool rotate_left;
+    bool rotate_right;
+    bool thrust;
+    bool brake;
+    bool shoot; /* edge triggered, set only on the step the button went down */
+    bool drag;  /* drags every asteroid under drag_position */
+    Vector2 drag_position;
+    bool paused; /* nothing moves, collisions and dragging still run */
+} WorldInputs;
+
+typedef struct
+{
+    Vector2 size; /* entities wrap around at these bounds, can be changed between steps */
+    double time;  /* sum of every dt passed to world_step */
+    float step_dt; /* movement time of the current step, 0 while paused, scales the swept tests */
+    unsigned int rng_state;
+    Ship ship;
+    AsteroidShapeBank asteroid_shapes; /* filled once by world_new, never changes */
+    AsteroidStore *asteroids;
+    Vec *projectile_vec;
+    SpatialHash *asteroid_grid;
+    Vec *asteroid_pair_vec;
+    AABBTree *asteroid_tree;
+    AABBTree *player_tree;
+    Vec *player_pair_vec;
+    Vec *player_block_vec; /* runs of player_pair_vec tested by one sat_collision_batch call */
+    JobPool *job_pool;
+    Vec **worker_contact_vecs; /* one Vec of Contact per worker */
+    CollisionStats *worker_stats; /* one per worker, added to collision_stats when the contacts are merged */
+    CollisionStats collision_stats; /* narrow phase cascade of the last step, both passes together */
+    Vec **worker_axis_vecs;         /* one Vec of axes found for asteroid pairs per worker */
+    AxisCache *axis_cache;          /* last separating or MTV axis of every asteroid pair, keyed by id */
+    Vec *contact_vec;          /* merged contacts, sorted by pair */
+    Vec *command_vec;                  /* structural changes of the current step, applied at its end */
+    unsigned char *asteroid_despawning; /* per asteroid, set while a despawn command for it is pending */
+    Vec *query_vec;                     /* candidates of the current world_query call */
+    Vec *drag_vec;                      /* asteroids under the drag position */
+    Vec *wrapped_vec;                   /* asteroids that wrapped around the field in the current step */
+    Arena *frame_arena; /* memory of the Vecs above that only live for one step */
+} World;
+
+/**
+ * @brief Creates a world with the starting ship and asteroids.
+ *
+ * @param size Width and height of the playing field.
+ * @param seed Seed of the world's random number generator.
+ * @param thread_count Workers of the narrow phase including the calling thread, 0 uses one per hardware thread.
+ * @return World*
+ */
+World *world_new(Vector2 size, unsigned int seed, int thread_count);
+
+/**
+ * @brief Creates a world with the starting ship and no asteroids.
+ *
+ * @param size Width and height of the playing field.
+ * @param seed Seed of the world's random number generator, the shape bank is drawn from it.
+ * @param thread_count Workers of the narrow phase including the calling thread, 0 uses one per hardware thread.
+ * @param asteroid_capacity Most asteroids alive at once, world_new uses ASTEROID_STORE_CAPACITY.
+ * @return World*
+ */
+World *world_new_empty(Vector2 size, unsigned int seed, int thread_count, int asteroid_capacity);
+
+/**
+ * @brief Frees the world and every entity in it.
+ *
+ * @param world World to free.
+ */
+void world_free(World *world);
+
+/**
+ * @brief Resets the frame arena, call once at the top of every frame before world_step.
+ *
+ * @param world World whose per step Vecs get fresh arena memory.
+ *
+ * @details Every arena backed Vec gets room for as many entries as it grew to before, so a frame like
+ * the last one allocates each Vec once from the arena and never from the heap. Not calling it is
+ * safe, the Vecs then keep their arena memory and the arena only grows with them.
+ */
+void world_begin_frame(World *world);
+
+/**
+ * @brief Advances the world by one tick.
+ *
+ * @param world World to step.
+ * @param dt Length of the tick in seconds.
+ * @param inputs Player input for this tick.
+ *
+ * @details Saves the previous position and rotation of every entity, shoots, refits the broad-phase trees, runs the ship/projectile vs asteroid pass,
+ * runs the asteroid vs asteroid pass, drags asteroids, moves every entity unless inputs->paused is set and finally
+ * commits the recorded commands: removes hit and expired projectiles and destroyed asteroids and spawns the split pieces.
+ */
+void world_step(World *world, float dt, const WorldInputs *inputs);
+
+/**
+ * @brief Returns a random value between min and max (both included) from the world's generator.
+ *
+ * @param world World owning the generator.
+ * @param min Smallest value.
+ * @param max Largest value.
+ * @return int
+ */
+int world_random_value(World *world, int min, int max);
+
+/**
+ * @brief Adds big asteroids at random positions of the playing field, for heavier scenes.
+ *
+ * @param world World to spawn into, positions are drawn from its generator.
+ * @param count Number of asteroids to add.
+ */
+void world_add_asteroids(World *world, int count);
+
+/**
+ * @brief FNV-1a hash of the whole simulation state.
+ *
+ * @param world World to hash.
+ * @return unsigned int Equal for two worlds that simulated the same game.
+ *
+ * @details Covers time, the random state, every asteroid column, the ship with its timers and every
+ * projectile. Caches rebuilt each tick (previous state, tree leaves, world shapes, colors) and the
+ * field size, which is an input, are left out.
+ */
+unsigned int world_checksum(const World *world);
+
+/**
+ * @brief Wraps a position that left the playing field to the opposite side.
+ *
+ * @param position Position to wrap.
+ * @param size Width and height of the playing field.
+ * @return int Number of axes that were wrapped.
+ */
+int return_to_screen(Vector2 *position, Vector2 size);
+
+/**
+ * @brief Spawns an asteroid with a random outline from the world's shape bank.
+ *
+ * @param world World to spawn into.
+ * @param asteroid_radius One of the ASTEROID_RADIUS_ sizes, other values use the small shapes.
+ * @param pos Position.
+ * @param vel Velocity.
+ * @return int Index of the new asteroid, -1 if the store is full.
+ */
+int asteroid_spawn(World *world, float asteroid_radius, Vector2 pos, Vector2 vel);
+
+/* Moves, wraps and clamps every asteroid with integrate_wrap, asteroids that wrapped get a random direction */
+void asteroid_update(World *world, float dt);
+
+/**
+ * @brief Bounces two overlapping asteroids off each other and pushes them apart.
+ *
+ * @param store Store containing both asteroids.
+ * @param asteroid0 Index of the first asteroid.
+ * @param asteroid1 Index of the second asteroid.
+ * @param mtv Minimum translation vector, pointing from asteroid1 towards asteroid0.
+ */
+void handle_asteroid_collision(AsteroidStore *store, int asteroid0, int asteroid1, Vector2 mtv);
+
+Ship ship_new(Vector2 pos, Vector2 vel);
+
+/* Applies the player's input and moves the ship */
+void ship_update(World *world, const WorldInputs *inputs, float dt);
+
+void ship_on_hit(Ship *ship, double time);
+
+/* Projectiles use the SHAPE_PROJECTILE prototype, creating one allocates nothing */
+Projectile projectile_new(float damage, Vector2 pos, Vector2 vel);
+
+void projectile_update(Projectile *projectile, float dt);
+
+#endif
@@ -0,0 +1,126 @@
+#include <raylib.h>
+#include <raymath.h>
+#include <stddef.h>
+#include "world_query.h"
+
+/* Candidates of a query in ascending index order, so results do not depend on the shape of the tree */
+static Vec *world_query_candidates(World *world)
+{
+    Vec *candidates = world->query_vec;
+    vec_sort_by_key(candidates, 0, VEC_KEY_INT32);
+    return candidates;
+}
+
+static bool world_query_outline(World *world, int asteroid, Vector2 point)
+{
+    AsteroidStore *store = world->asteroids;
+    const AsteroidShape *shape = asteroid_store_shape(store, asteroid);
+    return point_in_polygon(shape->outline, ASTEROID_POINTS, Vector2Add(store->position[asteroid], shape->center), store->rotation[asteroid], point);
+}
+
+int world_query_point(World *world, Vector2 point)
+{
+    int_vec_clear(world->query_vec);
+    aabb_tree_query(world->asteroid_tree, point, point, world->query_vec);
+    int result = -1;
+    size_t i;
+    for (i = 0; i < int_vec_size(world->query_vec); i++)
+    {
+        int asteroid = *int_vec_at(world->query_vec, i);
+        if (asteroid > result && world_query_outline(world, asteroid, point))
+        {
+            result = asteroid;
+        }
+    }
+    return result;
+}
+
+void world_query_point_all(World *world, Vector2 point, Vec *asteroids)
+{
+    int_vec_clear(asteroids);
+    int_vec_clear(world->query_vec);
+    aabb_tree_query(world->asteroid_tree, point, point, world->query_vec);
+    Vec *candidates = world_query_candidates(world);
+    size_t i;
+    for (i = 0; i < int_vec_size(candidates); i++)
+    {
+        int asteroid = *int_vec_at(candidates, i);
+        if (world_query_outline(world, asteroid, point))
+        {
+            int_vec_push_back(asteroids, &asteroid);
+        }
+    }
+}
+
+void world_query_radius(World *world, Vector2 center, float radius, Vec *asteroids)
+{
+    AsteroidStore *store = world->asteroids;
+    int_vec_clear(asteroids);
+    int_vec_clear(world->query_vec);
+    Vector2 extent = {radius, radius};
+    aabb_tree_query(world->asteroid_tree, Vector2Subtract(center, extent), Vector2Add(center, extent), world->query_vec);
+    Vec *candidates = world_query_candidates(world);
+    size_t i;
+    for (i = 0; i < int_vec_size(candidates); i++)
+    {
+        int asteroid = *int_vec_at(candidates, i);
+        if (circle_overlaps_shape(&store->world[asteroid], center, radius))
+        {
+            int_vec_push_back(asteroids, &asteroid);
+        }
+    }
+}
+
+/* Exact test of one candidate, fills everything but the asteroid of the hit */
+static bool world_query_segment_asteroid(World *world, int asteroid, Vector2 start, Vector2 end, WorldSegmentHit *hit)
+{
+    if (!segment_cast_shape(&world->asteroids->world[asteroid], start, end, &hit->t, &hit->normal))
+    {
+        return false;
+    }
+    hit->asteroid = asteroid;
+    hit->point = Vector2Lerp(start, end, hit->t);
+    return true;
+}
+
+bool world_query_segment(World *world, Vector2 start, Vector2 end, WorldSegmentHit *hit)
+{
+    int_vec_clear(world->query_vec);
+    aabb_tree_query_segment(world->asteroid_tree, start, end, world->query_vec);
+    bool found = false;
+    size_t i;
+    for (i = 0; i < int_vec_size(world->query_vec); i++)
+    {
+        WorldSegmentHit candidate;
+        int asteroid = *int_vec_at(world->query_vec, i);
+        if (!world_query_segment_asteroid(world, asteroid, start, end, &candidate))
+        {
+            continue;
+        }
+        if (!found || candidate.t < hit->t || (candidate.t == hit->t && asteroid < hit->asteroid))
+        {
+            *hit = candidate;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void world_query_segment_all(World *world, Vector2 start, Vector2 end, Vec *hits)
+{
+    world_segment_hit_vec_clear(hits);
+    int_vec_clear(world->query_vec);
+    aabb_tree_query_segment(world->asteroid_tree, start, end, world->query_vec);
+    Vec *candidates = world_query_candidates(world);
+    size_t i;
+    for (i = 0; i < int_vec_size(candidates); i++)
+    {
+        WorldSegmentHit hit;
+        if (world_query_segment_asteroid(world, *int_vec_at(candidates, i), start, end, &hit))
+        {
+            world_segment_hit_vec_push_back(hits, &hit);
+        }
+    }
+    /* Stable, so equal t keeps the ascending asteroid order */
+    vec_sort_by_key(hits, offsetof(WorldSegmentHit, t), VEC_KEY_FLOAT);
+}
@@ -0,0 +1,86 @@
+/**
+ * @brief Point, radius and segment queries over the asteroids of a world.
+ * @file world_query.h
+ *
+ */
+
+#ifndef WORLD_QUERY_H_
+#define WORLD_QUERY_H_
+
+#include <stdbool.h>
+#include <raylib.h>
+#include "world.h"
+
+/*
+    INFO:
+        Candidates come from the asteroid tree, so a query only visits the leaves whose fat AABB
+        it touches and then tests the asteroids behind them exactly. world_step refits the tree
+        at its end, so between steps the tree holds every asteroid where it is. Asteroids added
+        outside world_step (world_add_asteroids, snapshot_load) are found after the next step.
+        Point queries test the outline that is drawn, so picking matches what the player sees.
+        Radius and segment queries test the hitshape the collisions use.
+        Asteroids destroyed in the current step stay in the results until the commit removes them.
+        Queries share world->query_vec for their candidates and must not run concurrently.
+*/
+
+/* Asteroid hit by a segment */
+typedef struct
+{
+    int asteroid;
+    float t;        /* fraction of the segment from start to end at which it enters the asteroid */
+    Vector2 point;  /* start + t * (end - start) */
+    Vector2 normal; /* outward unit normal of the edge it enters through, zero if start is inside */
+} WorldSegmentHit;
+
+VEC_DEFINE(WorldSegmentHit, world_segment_hit)
+
+/**
+ * @brief Returns the asteroid drawn on top at a point.
+ *
+ * @param world World to query.
+ * @param point World space point.
+ * @return int Index of the asteroid, the highest one if several contain the point, -1 if none does.
+ */
+int world_query_point(World *world, Vector2 point);
+
+/**
+ * @brief Collects every asteroid containing a point.
+ *
+ * @param world World to query.
+ * @param point World space point.
+ * @param asteroids Vec of int, cleared and filled with asteroid indices in ascending order.
+ */
+void world_query_point_all(World *world, Vector2 point, Vec *asteroids);
+
+/**
+ * @brief Collects every asteroid touching a circle.
+ *
+ * @param world World to query.
+ * @param center Center of the circle.
+ * @param radius Radius of the circle.
+ * @param asteroids Vec of int, cleared and filled with asteroid indices in ascending order.
+ */
+void world_query_radius(World *world, Vector2 center, float radius, Vec *asteroids);
+
+/**
+ * @brief Finds the first asteroid along a segment.
+ *
+ * @param world World to query.
+ * @param start First point of the segment.
+ * @param end Last point of the segment.
+ * @param hit Set to the nearest hit, the lower index wins a tie. Untouched if nothing is hit.
+ * @return true if the segment touches an asteroid.
+ */
+bool world_query_segment(World *world, Vector2 start, Vector2 end, WorldSegmentHit *hit);
+
+/**
+ * @brief Collects every asteroid along a segment.
+ *
+ * @param world World to query.
+ * @param start First point of the segment.
+ * @param end Last point of the segment.
+ * @param hits Vec of WorldSegmentHit, cleared and filled nearest first, equal t in ascending asteroid order.
+ */
+void world_query_segment_all(World *world, Vector2 start, Vector2 end, Vec *hits);
+
+#endif